@@ -7,6 +7,10 @@ def configure(env):
 def get_doc_classes():
 	return [
 		"Steam",
+		"SteamHTMLRect",
+		"SteamHTMLTexture",
+		"SteamServerFilter",
+		"SteamVoiceStream",
 	]
 
 def get_doc_path():
@@ -20,8 +20,11 @@
 // Include some Godot headers
 #include "core/io/ip_address.h"
 #include "core/io/ip.h"
+#include "core/os/os.h"
+#include "servers/visual_server.h"
 
 // Include some system headers
+#include "algorithm"
 #include "fstream"
 #include "vector"
 
@@ -59,6 +62,25 @@
 #define PERSONA_NAME_MAX_UTF8 128
 #define PERSONA_NAME_MAX_UTF16 32
 
+// Define Avatar Atlas constants
+#define AVATAR_ATLAS_SIZE 1024
+#define AVATAR_ATLAS_SMALL_CELL 34
+#define AVATAR_ATLAS_MEDIUM_CELL 66
+
+// Define Game Search constants
+#define GAME_SEARCH_ROLE_PLAYER 0
+#define GAME_SEARCH_ROLE_HOST 1
+#define GAME_SEARCH_STATE_IDLE 0
+#define GAME_SEARCH_STATE_SEARCHING 1
+#define GAME_SEARCH_STATE_WAITING_RETRY 2
+#define GAME_SEARCH_STATE_FOUND 3
+#define GAME_SEARCH_STATE_ACCEPTED 4
+#define GAME_SEARCH_STATE_READY 5
+#define GAME_SEARCH_STATE_ENDED 6
+#define GAME_SEARCH_STATE_FAILED 7
+#define GAME_SEARCH_STATE_CANCELLED 8
+#define GAME_SEARCH_RETRY_MAX_DELAY 30.0f
+
 // Define HTML Surface constants
 #define INVALID_HTMLBROWSER 0
 
@@ -81,6 +103,10 @@
 // Define Matchmaking constants
 #define SERVER_QUERY_INVALID 0xffffffff
 #define MAX_LOBBY_KEY_LENGTH 255
+#define LOBBY_CHAT_MESSAGE_MAX 4000
+#define LOBBY_CHAT_FRAME_BINARY 1
+#define LOBBY_CHAT_FRAME_BATCH 2
+#define LOBBY_RANK_DEFAULT_PING 250
 #define FAVORITE_FLAG_FAVORITE 0x01
 #define FAVORITE_FLAG_HISTORY 0x02
 #define FAVORITE_FLAG_NONE 0x00
@@ -92,6 +118,13 @@
 #define MAX_GAME_SERVER_MAP_NAME 32
 #define MAX_GAME_SERVER_NAME 64
 #define MAX_GAME_SERVER_TAGS 128
+#define SERVER_SORT_PING 0
+#define SERVER_SORT_PLAYERS 1
+#define SERVER_SORT_MAP 2
+#define SERVER_SORT_NAME 3
+#define SERVER_QUERY_PING 1
+#define SERVER_QUERY_PLAYERS 2
+#define SERVER_QUERY_RULES 4
 
 // Define Music Remote constants
 #define MUSIC_NAME_MAX_LENGTH 255
@@ -102,6 +135,34 @@
 #define NETWORKING_SEND_NO_NAGLE 1
 #define NETWORKING_SEND_NO_DELAY 4
 #define NETWORKING_SEND_RELIABLE 8
+#define SESSION_ACCEPT_NONE 0
+#define SESSION_ACCEPT_FRIENDS 1
+#define SESSION_ACCEPT_LOBBY 2
+#define SESSION_ACCEPT_ALLOWLIST 4
+#define SESSION_CHECK_INTERVAL 1000000
+
+// Define Networking Capture constants
+#define MESSAGE_LOG_MAGIC "GSMSGLOG"
+#define MESSAGE_LOG_VERSION 1
+#define MESSAGE_LOG_MIN_SIZE 65536
+#define MESSAGE_LOG_ALIGN(size) (((uint64_t)(size) + 7) & ~(uint64_t)7)
+#define MESSAGE_LOG_DIRECTION_RECEIVED 0
+#define MESSAGE_LOG_DIRECTION_SENT 1
+#define MESSAGE_LOG_API_SOCKETS 0
+#define MESSAGE_LOG_API_MESSAGES 1
+#define MESSAGE_REPLAY_DRAIN_TIMEOUT 2000000
+
+// Define Networking Time Sync constants
+#define TIME_SYNC_PING 1
+#define TIME_SYNC_PONG 2
+#define TIME_SYNC_SAMPLES 16
+#define TIME_SYNC_MIN_SAMPLES 4
+#define TIME_SYNC_RECEIVE_MAX 32
+#define TIME_SYNC_MAX_DRIFT 0.0005
+
+// Define Networking Telemetry constants
+#define TELEMETRY_HISTOGRAM_BUCKETS 1024
+#define TELEMETRY_QUEUE_TIME_BUCKET 100
 
 // Define Remote Play constants
 #define DEVICE_FORM_FACTOR_UNKNOWN 0
@@ -143,6 +204,15 @@
 #define LEADERBOARD_NAME_MAX 128
 #define STAT_NAME_MAX 128
 
+// Define Voice constants
+#define VOICE_CAPTURE_BUFFER_SIZE 8192
+#define VOICE_DECOMPRESS_BUFFER_SIZE 22050
+#define VOICE_RECEIVE_MAX 64
+#define VOICE_SPEAKER_IDLE_TIMEOUT 10000000
+#define VOICE_SPEAKER_EXPIRY_INTERVAL 1000000
+#define VOICE_SEQUENCE_RESYNC_GAP 256
+#define VOICE_SEQUENCE_RESYNC_IDLE 1000000
+
 
 /////////////////////////////////////////////////
 ///// STEAM SINGLETON? STEAM SINGLETON
@@ -336,6 +406,7 @@ Steam::Steam():
 	callbackGetVideoResult(this, &Steam::get_video_result)
 {
 	is_init_success = false;
+	server_list_response = &server_list;
 	singleton = this;
 }
 
@@ -813,11 +884,28 @@ void Steam::activateGameOverlayToWebPage(const String& url){
 
 //! Clear the game information in Steam; used in 'View Game Info'.
 void Steam::clearRichPresence(){
+	rich_presence_written.clear();
+	rich_presence_pending.clear();
 	if(SteamFriends() != NULL){
 		SteamFriends()->ClearRichPresence();
 	}
 }
 
+//! Drop every avatar atlas page; regions handed out earlier are no longer valid.
+void Steam::clearAvatarAtlas(){
+	avatar_atlas_pages.clear();
+	avatar_atlas_slots.clear();
+	avatar_atlas_lru.clear();
+	avatar_atlas_pending.clear();
+}
+
+//! Drop every cached avatar texture. Avatars still loading are forgotten too, so the next getAvatarTexture asks Steam again.
+void Steam::clearAvatarCache(){
+	avatar_cache.clear();
+	avatar_cache_index.clear();
+	avatar_cache_pending.clear();
+}
+
 //! Closes the specified Steam group chat room in the Steam UI.
 bool Steam::closeClanChatWindowInSteam(uint64_t chat_id){
 	if(SteamFriends() == NULL){
@@ -843,6 +931,69 @@ void Steam::enumerateFollowingList(uint32 start_index){
 	}
 }
 
+//! Send every buffered rich presence change to Steam now instead of waiting for the flush interval.
+void Steam::flushRichPresence(){
+	rich_presence_last_flush = OS::get_singleton()->get_ticks_usec();
+	if(SteamFriends() == NULL){
+		return;
+	}
+	for(std::map<String, String>::iterator key = rich_presence_pending.begin(); key != rich_presence_pending.end(); ++key){
+		if(!SteamFriends()->SetRichPresence(key->first.utf8().get_data(), key->second.utf8().get_data())){
+			printf("[Steam] Failed to set rich presence key %s.\n", key->first.utf8().get_data());
+			continue;
+		}
+		if(key->second.empty()){
+			rich_presence_written.erase(key->first);
+		}
+		else{
+			rich_presence_written[key->first] = key->second;
+		}
+	}
+	rich_presence_pending.clear();
+}
+
+//! Get where a user's small or medium avatar sits in the shared avatar atlas: the atlas texture, the pixel region and the UV rect. Returns an empty dictionary while Steam is still fetching it, then avatar_atlas_updated is emitted once it is drawn. The atlas keeps as many avatars as the avatar cache; the least recently used are freed for reuse and announced through avatar_atlas_evicted.
+Dictionary Steam::getAvatarAtlasRegion(uint64_t steam_id, int size){
+	// If no Steam ID is given, use the current user's
+	if(steam_id == 0){
+		steam_id = getSteamID();
+	}
+	if(size != AVATAR_SMALL && size != AVATAR_MEDIUM){
+		printf("[Steam] Only small and medium avatars can be packed into the avatar atlas.\n");
+		return Dictionary();
+	}
+	std::pair<uint64_t, int> key(steam_id, size);
+	std::map<std::pair<uint64_t, int>, AvatarAtlasSlot>::iterator slot = avatar_atlas_slots.find(key);
+	if(slot != avatar_atlas_slots.end() && avatar_atlas_pending.count(key) == 0){
+		// Move to the front as the most recently used
+		avatar_atlas_lru.splice(avatar_atlas_lru.begin(), avatar_atlas_lru, slot->second.lru);
+		return slot->second.region.duplicate();
+	}
+	if(SteamFriends() == NULL || SteamUtils() == NULL || avatar_atlas_pending.count(key) > 0){
+		return Dictionary();
+	}
+	return fetchAtlasAvatar(steam_id, size);
+}
+
+//! Get a user's avatar as a ready texture from the avatar cache. Returns null while Steam is still fetching it, then avatar_texture_loaded is emitted once however many times it was requested.
+Ref<ImageTexture> Steam::getAvatarTexture(uint64_t steam_id, int size){
+	// If no Steam ID is given, use the current user's
+	if(steam_id == 0){
+		steam_id = getSteamID();
+	}
+	std::pair<uint64_t, int> key(steam_id, size);
+	std::map<std::pair<uint64_t, int>, std::list<AvatarCacheEntry>::iterator>::iterator cached = avatar_cache_index.find(key);
+	if(cached != avatar_cache_index.end()){
+		// Move to the front as the most recently used
+		avatar_cache.splice(avatar_cache.begin(), avatar_cache, cached->second);
+		return cached->second->texture;
+	}
+	if(SteamFriends() == NULL || SteamUtils() == NULL || size < AVATAR_SMALL || size > AVATAR_LARGE || avatar_cache_pending.count(key) > 0){
+		return Ref<ImageTexture>();
+	}
+	return fetchAvatar(steam_id, size);
+}
+
 //! Gets the Steam ID at the given index in a Steam group chat.
 uint64_t Steam::getChatMemberByIndex(uint64_t clan_id, int user){
 	if(SteamFriends() == NULL){
@@ -1206,6 +1357,67 @@ String Steam::getFriendsGroupName(int16 friend_group){
 	return String::utf8(SteamFriends()->GetFriendsGroupName(friend_group));
 }
 
+//! Get every rich presence key and value for many friends in one call, as a dictionary of Steam ID to key / value dictionary. Values come from a native mirror kept current by friend_rich_presence_update, so only friends seen for the first time are read from Steam.
+Dictionary Steam::getFriendsRichPresence(Array steam_ids){
+	Dictionary presence;
+	if(SteamFriends() == NULL){
+		return presence;
+	}
+	for(int i = 0; i < steam_ids.size(); i++){
+		uint64_t steam_id = steam_ids[i];
+		std::unordered_map<uint64_t, std::map<String, String>>::iterator found = rich_presence_mirror.find(steam_id);
+		const std::map<String, String> &keys = (found != rich_presence_mirror.end()) ? found->second : mirrorFriendRichPresence(steam_id);
+		Dictionary values;
+		for(std::map<String, String>::const_iterator key = keys.begin(); key != keys.end(); ++key){
+			values[key->first] = key->second;
+		}
+		presence[steam_id] = values;
+	}
+	return presence;
+}
+
+//! Get the rich presence keys that were added, changed or removed for each friend since the last call, as a dictionary of Steam ID to key names.
+Dictionary Steam::getFriendsRichPresenceChanges(){
+	Dictionary changes;
+	for(std::map<uint64_t, std::set<String>>::iterator friend_changes = rich_presence_changes.begin(); friend_changes != rich_presence_changes.end(); ++friend_changes){
+		PoolStringArray keys;
+		for(std::set<String>::iterator key = friend_changes->second.begin(); key != friend_changes->second.end(); ++key){
+			keys.append(*key);
+		}
+		changes[(uint64_t)friend_changes->first] = keys;
+	}
+	rich_presence_changes.clear();
+	return changes;
+}
+
+//! Get every friend's ID, name, persona state, game played, Steam level and relationship as packed arrays in one call. The snapshot is then kept up to date from persona and rich presence callbacks, so later calls with the same flags cost no Steamworks calls; changes arrive once per frame through friends_snapshot_changed.
+Dictionary Steam::getFriendsSnapshot(int friend_flags){
+	if(SteamFriends() == NULL){
+		return Dictionary();
+	}
+	if(!friends_snapshot_active || friend_flags != friends_snapshot_flags){
+		friends_snapshot.clear();
+		friends_snapshot_index.clear();
+		friends_snapshot_changes.clear();
+		friends_snapshot_removed.clear();
+		int count = SteamFriends()->GetFriendCount(friend_flags);
+		friends_snapshot.resize(MAX(count, 0));
+		for(int i = 0; i < count; i++){
+			FriendSnapshotEntry &entry = friends_snapshot[i];
+			entry.steam_id = SteamFriends()->GetFriendByIndex(i, friend_flags).ConvertToUint64();
+			readFriendSnapshotEntry(entry, -1);
+			friends_snapshot_index[entry.steam_id] = i;
+		}
+		friends_snapshot_flags = friend_flags;
+		friends_snapshot_active = true;
+	}
+	std::vector<uint32_t> indices(friends_snapshot.size());
+	for(uint32_t i = 0; i < indices.size(); i++){
+		indices[i] = i;
+	}
+	return packFriendsSnapshot(indices);
+}
+
 //! Get friend's steam level, obviously.
 int Steam::getFriendSteamLevel(uint64_t steam_id){
 	if(SteamFriends() == NULL){
@@ -1573,6 +1785,18 @@ bool Steam::sendClanChatMessage(uint64_t chat_id, const String& text){
 	return SteamFriends()->SendClanChatMessage(chat, text.utf8().get_data());
 }
 
+//! Set how many avatars the avatar atlas keeps before freeing the least recently used slots, at least one. Defaults to one page of small avatars.
+void Steam::setAvatarAtlasSize(uint32 max_slots){
+	avatar_atlas_size = MAX(max_slots, (uint32)1);
+	trimAvatarAtlas(avatar_atlas_size);
+}
+
+//! Set how many avatar textures the avatar cache keeps before dropping the least recently used.
+void Steam::setAvatarCacheSize(uint32 max_entries){
+	avatar_cache_size = max_entries;
+	trimAvatarCache();
+}
+
 //! User is in a game pressing the talk button (will suppress the microphone for all voice comms from the Steam friends UI).
 void Steam::setInGameVoiceSpeaking(uint64_t steam_id, bool speaking){
 	if(SteamFriends() != NULL){
@@ -1613,7 +1837,461 @@ bool Steam::setRichPresence(const String& key, const String& value){
 	if(SteamFriends() == NULL){
 		return false;
 	}
-	return SteamFriends()->SetRichPresence(key.utf8().get_data(), value.utf8().get_data());
+	// Values already written, or already waiting to be, cost no IPC call
+	std::map<String, String>::iterator pending = rich_presence_pending.find(key);
+	std::map<String, String>::iterator written = rich_presence_written.find(key);
+	bool unchanged = (written != rich_presence_written.end()) ? (written->second == value) : value.empty();
+	if(pending != rich_presence_pending.end()){
+		if(unchanged){
+			rich_presence_pending.erase(pending);
+		}
+		else{
+			pending->second = value;
+		}
+		return true;
+	}
+	if(unchanged){
+		return true;
+	}
+	if(rich_presence_interval == 0){
+		if(!SteamFriends()->SetRichPresence(key.utf8().get_data(), value.utf8().get_data())){
+			return false;
+		}
+		if(value.empty()){
+			rich_presence_written.erase(key);
+		}
+		else{
+			rich_presence_written[key] = value;
+		}
+		return true;
+	}
+	// Buffered changes can only be checked against Steam's limits here
+	if(key.utf8().length() >= k_cchMaxRichPresenceKeyLength || value.utf8().length() >= k_cchMaxRichPresenceValueLength){
+		return false;
+	}
+	rich_presence_pending[key] = value;
+	return true;
+}
+
+//! Buffer setRichPresence changes and send them to Steam together at most once per interval, in seconds. An interval of 0 writes each change straight through.
+void Steam::setRichPresenceFlushInterval(float interval){
+	rich_presence_interval = (uint64_t)(MAX(interval, 0.0f) * 1000000);
+	if(rich_presence_interval == 0){
+		flushRichPresence();
+	}
+}
+
+// Get the image handle of an avatar. Returns -1 if Steam still has to fetch it; large avatars then arrive through avatar_loaded, smaller ones after the user's information.
+int Steam::getAvatarHandle(uint64_t steam_id, int size){
+	CSteamID user_id = (uint64)steam_id;
+	int handle = 0;
+	switch(size){
+		case AVATAR_SMALL:{
+			handle = SteamFriends()->GetSmallFriendAvatar(user_id);
+			break;
+		}
+		case AVATAR_MEDIUM:{
+			handle = SteamFriends()->GetMediumFriendAvatar(user_id);
+			break;
+		}
+		case AVATAR_LARGE:{
+			handle = SteamFriends()->GetLargeFriendAvatar(user_id);
+			break;
+		}
+	}
+	if(handle == 0 && SteamFriends()->RequestUserInformation(user_id, false)){
+		return -1;
+	}
+	return handle;
+}
+
+// Copy a loaded Steam image into a Godot image.
+Ref<Image> Steam::getAvatarImage(int handle){
+	uint32 width = 0;
+	uint32 height = 0;
+	if(!SteamUtils()->GetImageSize(handle, &width, &height) || width == 0 || height == 0){
+		printf("[Steam] Failed to get avatar image size.\n");
+		return Ref<Image>();
+	}
+	PoolByteArray data;
+	data.resize(width * height * 4);
+	if(!SteamUtils()->GetImageRGBA(handle, data.write().ptr(), data.size())){
+		printf("[Steam] Failed to load avatar image buffer.\n");
+		return Ref<Image>();
+	}
+	Ref<Image> image;
+	image.instance();
+	image->create(width, height, false, Image::FORMAT_RGBA8, data);
+	return image;
+}
+
+// Get the avatar image and cache it, or mark the avatar pending if Steam still has to fetch it.
+Ref<ImageTexture> Steam::fetchAvatar(uint64_t steam_id, int size){
+	std::pair<uint64_t, int> key(steam_id, size);
+	int handle = getAvatarHandle(steam_id, size);
+	if(handle == -1){
+		avatar_cache_pending.insert(key);
+		return Ref<ImageTexture>();
+	}
+	avatar_cache_pending.erase(key);
+	if(handle <= 0){
+		return Ref<ImageTexture>();
+	}
+	return cacheAvatar(steam_id, size, getAvatarImage(handle));
+}
+
+// Build a texture from a loaded avatar image and add it to the front of the avatar cache.
+Ref<ImageTexture> Steam::cacheAvatar(uint64_t steam_id, int size, const Ref<Image>& image){
+	if(image.is_null()){
+		return Ref<ImageTexture>();
+	}
+	Ref<ImageTexture> texture;
+	texture.instance();
+	texture->create_from_image(image, Texture::FLAG_FILTER);
+	std::pair<uint64_t, int> key(steam_id, size);
+	std::map<std::pair<uint64_t, int>, std::list<AvatarCacheEntry>::iterator>::iterator cached = avatar_cache_index.find(key);
+	if(cached != avatar_cache_index.end()){
+		avatar_cache.erase(cached->second);
+	}
+	AvatarCacheEntry entry;
+	entry.steam_id = steam_id;
+	entry.size = size;
+	entry.texture = texture;
+	avatar_cache.push_front(entry);
+	avatar_cache_index[key] = avatar_cache.begin();
+	trimAvatarCache();
+	return texture;
+}
+
+// Drop least recently used avatars until the cache fits its size.
+void Steam::trimAvatarCache(){
+	while(avatar_cache.size() > avatar_cache_size){
+		const AvatarCacheEntry &oldest = avatar_cache.back();
+		avatar_cache_index.erase(std::pair<uint64_t, int>(oldest.steam_id, oldest.size));
+		avatar_cache.pop_back();
+	}
+}
+
+// Get the avatar image and draw it into its atlas slot, or mark it pending if Steam still has to fetch it.
+Dictionary Steam::fetchAtlasAvatar(uint64_t steam_id, int size){
+	std::pair<uint64_t, int> key(steam_id, size);
+	int handle = getAvatarHandle(steam_id, size);
+	if(handle == -1){
+		avatar_atlas_pending.insert(key);
+		return Dictionary();
+	}
+	avatar_atlas_pending.erase(key);
+	if(handle <= 0){
+		return Dictionary();
+	}
+	return drawAtlasAvatar(steam_id, size, getAvatarImage(handle));
+}
+
+// Draw a loaded avatar image into the user's atlas slot, taking a free cell or a new page if they have none.
+Dictionary Steam::drawAtlasAvatar(uint64_t steam_id, int size, const Ref<Image>& image){
+	if(image.is_null()){
+		return Dictionary();
+	}
+	std::pair<uint64_t, int> key(steam_id, size);
+	int cell_size = ((size == AVATAR_SMALL) ? AVATAR_ATLAS_SMALL_CELL : AVATAR_ATLAS_MEDIUM_CELL);
+	int width = image->get_width();
+	int height = image->get_height();
+	if(width > cell_size - 2 || height > cell_size - 2){
+		printf("[Steam] Avatar image is too large for its atlas cell.\n");
+		return Dictionary();
+	}
+	// Reuse the user's slot when their avatar changes, otherwise take the first free cell
+	std::map<std::pair<uint64_t, int>, AvatarAtlasSlot>::iterator slot = avatar_atlas_slots.find(key);
+	if(slot == avatar_atlas_slots.end()){
+		// Free the least recently used slots first so their cells are reused instead of adding pages
+		trimAvatarAtlas(avatar_atlas_size - 1);
+		AvatarAtlasSlot new_slot;
+		new_slot.page = -1;
+		new_slot.cell = -1;
+		for(int i = 0; i < (int)avatar_atlas_pages.size() && new_slot.page < 0; i++){
+			AvatarAtlasPage &page = avatar_atlas_pages[i];
+			if(page.cell_size != cell_size){
+				continue;
+			}
+			for(int j = 0; j < (int)page.used.size(); j++){
+				if(!page.used[j]){
+					new_slot.page = i;
+					new_slot.cell = j;
+					break;
+				}
+			}
+		}
+		if(new_slot.page < 0){
+			AvatarAtlasPage page;
+			page.cell_size = cell_size;
+			int columns = AVATAR_ATLAS_SIZE / cell_size;
+			page.used.resize(columns * columns, false);
+			Ref<Image> blank;
+			blank.instance();
+			blank->create(AVATAR_ATLAS_SIZE, AVATAR_ATLAS_SIZE, false, Image::FORMAT_RGBA8);
+			page.texture.instance();
+			page.texture->create_from_image(blank, Texture::FLAG_FILTER);
+			avatar_atlas_pages.push_back(page);
+			new_slot.page = avatar_atlas_pages.size() - 1;
+			new_slot.cell = 0;
+		}
+		avatar_atlas_pages[new_slot.page].used[new_slot.cell] = true;
+		avatar_atlas_lru.push_front(key);
+		new_slot.lru = avatar_atlas_lru.begin();
+		slot = avatar_atlas_slots.insert(std::make_pair(key, new_slot)).first;
+	}
+	else{
+		avatar_atlas_lru.splice(avatar_atlas_lru.begin(), avatar_atlas_lru, slot->second.lru);
+	}
+	AvatarAtlasPage &page = avatar_atlas_pages[slot->second.page];
+	int columns = AVATAR_ATLAS_SIZE / cell_size;
+	int cell_x = (slot->second.cell % columns) * cell_size;
+	int cell_y = (slot->second.cell / columns) * cell_size;
+	// Pad with a one pixel copy of the edges so filtering does not bleed in neighbouring avatars
+	PoolByteArray source = image->get_data();
+	PoolByteArray padded_data;
+	padded_data.resize((width + 2) * (height + 2) * 4);
+	{
+		PoolByteArray::Read source_read = source.read();
+		PoolByteArray::Write padded_write = padded_data.write();
+		for(int y = 0; y < height + 2; y++){
+			int source_y = CLAMP(y - 1, 0, height - 1);
+			for(int x = 0; x < width + 2; x++){
+				int source_x = CLAMP(x - 1, 0, width - 1);
+				memcpy(&padded_write[(y * (width + 2) + x) * 4], &source_read[(source_y * width + source_x) * 4], 4);
+			}
+		}
+	}
+	Ref<Image> padded;
+	padded.instance();
+	padded->create(width + 2, height + 2, false, Image::FORMAT_RGBA8, padded_data);
+	VisualServer::get_singleton()->texture_set_data_partial(page.texture->get_rid(), padded, 0, 0, width + 2, height + 2, cell_x, cell_y, 0);
+	Rect2 region(cell_x + 1, cell_y + 1, width, height);
+	Dictionary atlas_region;
+	atlas_region["texture"] = page.texture;
+	atlas_region["region"] = region;
+	atlas_region["uv"] = Rect2(region.position / AVATAR_ATLAS_SIZE, region.size / AVATAR_ATLAS_SIZE);
+	slot->second.region = atlas_region;
+	return atlas_region.duplicate();
+}
+
+// Free least recently used atlas slots until at most max_slots remain; their users are told through avatar_atlas_evicted.
+void Steam::trimAvatarAtlas(uint32 max_slots){
+	while(avatar_atlas_slots.size() > max_slots && !avatar_atlas_lru.empty()){
+		std::pair<uint64_t, int> oldest = avatar_atlas_lru.back();
+		avatar_atlas_lru.pop_back();
+		std::map<std::pair<uint64_t, int>, AvatarAtlasSlot>::iterator slot = avatar_atlas_slots.find(oldest);
+		if(slot == avatar_atlas_slots.end()){
+			continue;
+		}
+		avatar_atlas_pages[slot->second.page].used[slot->second.cell] = false;
+		avatar_atlas_slots.erase(slot);
+		emit_signal("avatar_atlas_evicted", oldest.first, oldest.second);
+	}
+}
+
+// Fetch a pending avatar again now that Steam may have it, and tell script if it arrived. An image already read from Steam is used as is instead of being fetched again.
+void Steam::resolvePendingAvatar(uint64_t steam_id, int size, const Ref<Image>& image){
+	if(SteamFriends() == NULL || SteamUtils() == NULL){
+		return;
+	}
+	std::pair<uint64_t, int> key(steam_id, size);
+	if(avatar_cache_pending.count(key) > 0){
+		Ref<ImageTexture> texture;
+		if(image.is_valid()){
+			avatar_cache_pending.erase(key);
+			texture = cacheAvatar(steam_id, size, image);
+		}
+		else{
+			texture = fetchAvatar(steam_id, size);
+		}
+		if(texture.is_valid()){
+			emit_signal("avatar_texture_loaded", steam_id, size, texture);
+		}
+	}
+	if(avatar_atlas_pending.count(key) > 0){
+		Dictionary atlas_region;
+		if(image.is_valid()){
+			avatar_atlas_pending.erase(key);
+			atlas_region = drawAtlasAvatar(steam_id, size, image);
+		}
+		else{
+			atlas_region = fetchAtlasAvatar(steam_id, size);
+		}
+		if(!atlas_region.empty()){
+			emit_signal("avatar_atlas_updated", steam_id, size, atlas_region["texture"], atlas_region["region"]);
+		}
+	}
+}
+
+
+// Read the fields of a friends snapshot entry covered by a set of persona change flags.
+void Steam::readFriendSnapshotEntry(FriendSnapshotEntry& entry, int flags){
+	CSteamID friend_id = (uint64)entry.steam_id;
+	if(flags & (k_EPersonaChangeName | k_EPersonaChangeNameFirstSet)){
+		entry.name = String::utf8(SteamFriends()->GetFriendPersonaName(friend_id));
+	}
+	if(flags & (k_EPersonaChangeStatus | k_EPersonaChangeComeOnline | k_EPersonaChangeGoneOffline)){
+		entry.state = SteamFriends()->GetFriendPersonaState(friend_id);
+	}
+	if(flags & (k_EPersonaChangeGamePlayed | k_EPersonaChangeGameServer | k_EPersonaChangeComeOnline | k_EPersonaChangeGoneOffline)){
+		FriendGameInfo_t game_info;
+		entry.game_id = SteamFriends()->GetFriendGamePlayed(friend_id, &game_info) ? game_info.m_gameID.AppID() : 0;
+	}
+	if(flags & k_EPersonaChangeSteamLevel){
+		entry.level = SteamFriends()->GetFriendSteamLevel(friend_id);
+	}
+	if(flags & k_EPersonaChangeRelationshipChanged){
+		entry.relationship = SteamFriends()->GetFriendRelationship(friend_id);
+	}
+}
+
+// Apply a persona or rich presence change to the friends snapshot, adding or dropping the friend if the relationship changed.
+void Steam::trackFriendChange(uint64_t steam_id, int flags){
+	if(!friends_snapshot_active || SteamFriends() == NULL){
+		return;
+	}
+	CSteamID friend_id = (uint64)steam_id;
+	std::unordered_map<uint64_t, uint32_t>::iterator found = friends_snapshot_index.find(steam_id);
+	if(found == friends_snapshot_index.end()){
+		if(!(flags & k_EPersonaChangeRelationshipChanged) || !SteamFriends()->HasFriend(friend_id, friends_snapshot_flags)){
+			return;
+		}
+		FriendSnapshotEntry entry;
+		entry.steam_id = steam_id;
+		readFriendSnapshotEntry(entry, -1);
+		friends_snapshot_index[steam_id] = friends_snapshot.size();
+		friends_snapshot.push_back(entry);
+		friends_snapshot_removed.erase(steam_id);
+		friends_snapshot_changes[steam_id] |= flags;
+		return;
+	}
+	if((flags & k_EPersonaChangeRelationshipChanged) && !SteamFriends()->HasFriend(friend_id, friends_snapshot_flags)){
+		// Swap the last entry into the hole so the arrays stay dense
+		uint32_t index = found->second;
+		friends_snapshot_index.erase(found);
+		if(index != friends_snapshot.size() - 1){
+			friends_snapshot[index] = friends_snapshot.back();
+			friends_snapshot_index[friends_snapshot[index].steam_id] = index;
+		}
+		friends_snapshot.pop_back();
+		friends_snapshot_changes.erase(steam_id);
+		friends_snapshot_removed.insert(steam_id);
+		return;
+	}
+	readFriendSnapshotEntry(friends_snapshot[found->second], flags);
+	friends_snapshot_changes[steam_id] |= flags;
+}
+
+// Pack friends snapshot entries into parallel arrays; Steam IDs need 64 bits so they go in a plain Array.
+Dictionary Steam::packFriendsSnapshot(const std::vector<uint32_t>& indices){
+	Array steam_ids;
+	PoolStringArray names;
+	PoolIntArray states;
+	PoolIntArray game_ids;
+	PoolIntArray levels;
+	PoolIntArray relationships;
+	steam_ids.resize(indices.size());
+	names.resize(indices.size());
+	states.resize(indices.size());
+	game_ids.resize(indices.size());
+	levels.resize(indices.size());
+	relationships.resize(indices.size());
+	{
+		PoolStringArray::Write names_write = names.write();
+		PoolIntArray::Write states_write = states.write();
+		PoolIntArray::Write game_ids_write = game_ids.write();
+		PoolIntArray::Write levels_write = levels.write();
+		PoolIntArray::Write relationships_write = relationships.write();
+		for(uint32_t i = 0; i < indices.size(); i++){
+			const FriendSnapshotEntry &entry = friends_snapshot[indices[i]];
+			steam_ids[i] = (uint64_t)entry.steam_id;
+			names_write[i] = entry.name;
+			states_write[i] = entry.state;
+			game_ids_write[i] = entry.game_id;
+			levels_write[i] = entry.level;
+			relationships_write[i] = entry.relationship;
+		}
+	}
+	Dictionary snapshot;
+	snapshot["steam_ids"] = steam_ids;
+	snapshot["names"] = names;
+	snapshot["states"] = states;
+	snapshot["game_ids"] = game_ids;
+	snapshot["levels"] = levels;
+	snapshot["relationships"] = relationships;
+	return snapshot;
+}
+
+// Send the friends changed this frame as one change set.
+void Steam::updateFriendsSnapshot(){
+	std::vector<uint32_t> indices;
+	PoolIntArray flags;
+	indices.reserve(friends_snapshot_changes.size());
+	for(std::map<uint64_t, int>::iterator change = friends_snapshot_changes.begin(); change != friends_snapshot_changes.end(); ++change){
+		std::unordered_map<uint64_t, uint32_t>::iterator found = friends_snapshot_index.find(change->first);
+		if(found != friends_snapshot_index.end()){
+			indices.push_back(found->second);
+			flags.append(change->second);
+		}
+	}
+	Dictionary changes = packFriendsSnapshot(indices);
+	changes["flags"] = flags;
+	Array removed;
+	for(std::set<uint64_t>::iterator steam_id = friends_snapshot_removed.begin(); steam_id != friends_snapshot_removed.end(); ++steam_id){
+		removed.append((uint64_t)*steam_id);
+	}
+	changes["removed"] = removed;
+	friends_snapshot_changes.clear();
+	friends_snapshot_removed.clear();
+	emit_signal("friends_snapshot_changed", changes);
+}
+
+// Flush buffered rich presence changes once the interval has passed since the last flush.
+void Steam::updateRichPresence(){
+	if(OS::get_singleton()->get_ticks_usec() - rich_presence_last_flush >= rich_presence_interval){
+		flushRichPresence();
+	}
+}
+
+// Read a friend's rich presence into the mirror, noting every key that differs from what was mirrored before. A friend's first read only seeds the mirror.
+std::map<String, String>& Steam::mirrorFriendRichPresence(uint64_t steam_id){
+	CSteamID friend_id = (uint64)steam_id;
+	std::map<String, String> keys;
+	int key_count = SteamFriends()->GetFriendRichPresenceKeyCount(friend_id);
+	for(int i = 0; i < key_count; i++){
+		const char* key = SteamFriends()->GetFriendRichPresenceKeyByIndex(friend_id, i);
+		keys[String::utf8(key)] = String::utf8(SteamFriends()->GetFriendRichPresence(friend_id, key));
+	}
+	std::unordered_map<uint64_t, std::map<String, String>>::iterator found = rich_presence_mirror.find(steam_id);
+	if(found == rich_presence_mirror.end()){
+		std::map<String, String> &seeded = rich_presence_mirror[steam_id];
+		seeded.swap(keys);
+		return seeded;
+	}
+	std::map<String, String> &mirrored = found->second;
+	std::set<String> changed;
+	diffKeyValues(mirrored, keys, changed);
+	if(!changed.empty()){
+		rich_presence_changes[steam_id].insert(changed.begin(), changed.end());
+	}
+	mirrored.swap(keys);
+	return mirrored;
+}
+
+// Collect every key that was added, changed or removed between two sets of key / value pairs.
+void Steam::diffKeyValues(const std::map<String, String>& old_values, const std::map<String, String>& new_values, std::set<String>& changed){
+	for(std::map<String, String>::const_iterator key = new_values.begin(); key != new_values.end(); ++key){
+		std::map<String, String>::const_iterator old_key = old_values.find(key->first);
+		if(old_key == old_values.end() || old_key->second != key->second){
+			changed.insert(key->first);
+		}
+	}
+	for(std::map<String, String>::const_iterator old_key = old_values.begin(); old_key != old_values.end(); ++old_key){
+		if(new_values.count(old_key->first) == 0){
+			changed.insert(old_key->first);
+		}
+	}
 }
 
 
@@ -1651,7 +2329,11 @@ int Steam::acceptGame(){
 	if(SteamGameSearch() == NULL){
 		return 9;
 	}
-	return SteamGameSearch()->AcceptGame();
+	int error = SteamGameSearch()->AcceptGame();
+	if(error == k_EGameSearchErrorCode_OK && game_search_runs[GAME_SEARCH_ROLE_PLAYER].state == GAME_SEARCH_STATE_FOUND){
+		setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_ACCEPTED);
+	}
+	return error;
 }
 
 //! After receiving SearchForGameResultCallback_t, accept or decline the game. Multiple SearchForGameResultCallback_t will follow as players accept game until the host starts or cancels the game.
@@ -1659,7 +2341,13 @@ int Steam::declineGame(){
 	if(SteamGameSearch() == NULL){
 		return 9;
 	}
-	return SteamGameSearch()->DeclineGame();
+	int error = SteamGameSearch()->DeclineGame();
+	if(error == k_EGameSearchErrorCode_OK && game_search_runs[GAME_SEARCH_ROLE_PLAYER].state == GAME_SEARCH_STATE_FOUND){
+		Dictionary details;
+		details["reason"] = "declined";
+		setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_CANCELLED, details);
+	}
+	return error;
 }
 
 //! After receiving GameStartedByHostCallback_t get connection details to server.
@@ -1741,6 +2429,249 @@ int Steam::endGame(uint64_t game_id){
 	return SteamGameSearch()->EndGame(game_id);
 }
 
+//! Run a search for a game end to end: search parameters are added, the search started with searchForGameWithLobby or searchForGameSolo, found games accepted when auto_accept is set and failed or fallen through searches retried with a doubling delay. Settings are lobby_id (0 searches solo), player_min, player_max, params (a dictionary of key and comma separated values), auto_accept, accept_timeout (seconds, 0 waits forever), retries and retry_delay (seconds). Every change arrives through game_search_state.
+bool Steam::startGameSearch(Dictionary settings){
+	if(SteamGameSearch() == NULL){
+		return false;
+	}
+	// A search still running would make the new one fail as already in progress
+	cancelGameSearch(GAME_SEARCH_ROLE_PLAYER);
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_PLAYER];
+	std::set<uint64_t> ended_searches;
+	ended_searches.swap(run.ended_searches);
+	run = GameSearchRun();
+	run.ended_searches.swap(ended_searches);
+	run.settings = settings;
+	return launchGameSearch(GAME_SEARCH_ROLE_PLAYER);
+}
+
+//! Host a game end to end: host parameters and connection details are set, players requested with requestPlayersForGame, each player's accept or decline tracked and the start confirmed with hostConfirmGameStart once everyone found has accepted when auto_confirm is set. Searches that fail, or are not accepted within accept_timeout seconds, are retried with a doubling delay. Settings are player_min, player_max, max_team_size, params (a dictionary of host keys and values), connection_details, auto_confirm, accept_timeout, retries and retry_delay. Every change arrives through game_search_state.
+bool Steam::startGameHostSearch(Dictionary settings){
+	if(SteamGameSearch() == NULL){
+		return false;
+	}
+	// A search still running would make the new one fail as already in progress
+	cancelGameSearch(GAME_SEARCH_ROLE_HOST);
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_HOST];
+	std::set<uint64_t> ended_searches;
+	ended_searches.swap(run.ended_searches);
+	run = GameSearchRun();
+	run.ended_searches.swap(ended_searches);
+	run.settings = settings;
+	return launchGameSearch(GAME_SEARCH_ROLE_HOST);
+}
+
+//! Stop a search started with startGameSearch or startGameHostSearch.
+void Steam::cancelGameSearch(int role){
+	if(role != GAME_SEARCH_ROLE_PLAYER && role != GAME_SEARCH_ROLE_HOST){
+		return;
+	}
+	int state = game_search_runs[role].state;
+	if(state == GAME_SEARCH_STATE_IDLE || state == GAME_SEARCH_STATE_ENDED || state == GAME_SEARCH_STATE_FAILED || state == GAME_SEARCH_STATE_CANCELLED){
+		return;
+	}
+	if(state != GAME_SEARCH_STATE_WAITING_RETRY){
+		endGameSearch(role);
+	}
+	Dictionary details;
+	details["reason"] = "cancelled";
+	setGameSearchState(role, GAME_SEARCH_STATE_CANCELLED, details);
+}
+
+//! Get the state, attempt, search and game IDs, host and, for hosts, each found player's accept state and suggested team.
+Dictionary Steam::getGameSearchStatus(int role){
+	if(role != GAME_SEARCH_ROLE_PLAYER && role != GAME_SEARCH_ROLE_HOST){
+		return Dictionary();
+	}
+	return gameSearchDetails(role);
+}
+
+// Make the Steam calls that start an attempt; errors that may clear up on their own are retried.
+bool Steam::launchGameSearch(int role){
+	GameSearchRun &run = game_search_runs[role];
+	const Dictionary &settings = run.settings;
+	run.attempt++;
+	run.search_id = 0;
+	run.game_id = 0;
+	run.host_id = 0;
+	run.accept_deadline = 0;
+	run.players.clear();
+	EGameSearchErrorCode_t error;
+	Dictionary params = settings.get("params", Dictionary());
+	Array keys = params.keys();
+	if(role == GAME_SEARCH_ROLE_PLAYER){
+		for(int i = 0; i < keys.size(); i++){
+			String key = keys[i];
+			String values = params[keys[i]];
+			SteamGameSearch()->AddGameSearchParams(key.utf8().get_data(), values.utf8().get_data());
+		}
+		int player_min = settings.get("player_min", 1);
+		int player_max = settings.get("player_max", 1);
+		uint64_t lobby_id = settings.get("lobby_id", 0);
+		if(lobby_id != 0){
+			error = SteamGameSearch()->SearchForGameWithLobby(CSteamID((uint64)lobby_id), player_min, player_max);
+		}
+		else{
+			error = SteamGameSearch()->SearchForGameSolo(player_min, player_max);
+		}
+	}
+	else{
+		for(int i = 0; i < keys.size(); i++){
+			String key = keys[i];
+			String value = params[keys[i]];
+			SteamGameSearch()->SetGameHostParams(key.utf8().get_data(), value.utf8().get_data());
+		}
+		String connection_details = settings.get("connection_details", "");
+		if(!connection_details.empty()){
+			CharString details = connection_details.utf8();
+			SteamGameSearch()->SetConnectionDetails(details.get_data(), details.length() + 1);
+		}
+		error = SteamGameSearch()->RequestPlayersForGame(settings.get("player_min", 1), settings.get("player_max", 1), settings.get("max_team_size", 1));
+	}
+	if(error == k_EGameSearchErrorCode_OK){
+		setGameSearchState(role, GAME_SEARCH_STATE_SEARCHING);
+		return true;
+	}
+	if(error == k_EGameSearchErrorCode_Failed_Offline || error == k_EGameSearchErrorCode_Failed_No_Host_Available || error == k_EGameSearchErrorCode_Failed_Unknown_Error){
+		retryGameSearch(role, "error_" + itos(error));
+		return true;
+	}
+	Dictionary details;
+	details["reason"] = "error_" + itos(error);
+	setGameSearchState(role, GAME_SEARCH_STATE_FAILED, details);
+	return false;
+}
+
+// End the current attempt, then wait retry_delay, doubled for every attempt so far, before starting again; fail once the retries are used up.
+void Steam::retryGameSearch(int role, const String& reason){
+	GameSearchRun &run = game_search_runs[role];
+	// Ending the search also drops its parameters, so the next attempt adds them again
+	endGameSearch(role);
+	Dictionary details;
+	details["reason"] = reason;
+	int retries = run.settings.get("retries", 3);
+	if((int)run.attempt > retries){
+		setGameSearchState(role, GAME_SEARCH_STATE_FAILED, details);
+		return;
+	}
+	float delay = run.settings.get("retry_delay", 1.0);
+	delay = MIN(delay * (float)(1 << MIN(run.attempt - 1, (uint32_t)16)), GAME_SEARCH_RETRY_MAX_DELAY);
+	run.retry_at = OS::get_singleton()->get_ticks_usec() + (uint64_t)(MAX(delay, 0.0f) * 1000000);
+	details["retry_in"] = delay;
+	setGameSearchState(role, GAME_SEARCH_STATE_WAITING_RETRY, details);
+}
+
+// End the current attempt's Steam search and remember its ID, so its late callbacks are not taken for the next attempt's.
+void Steam::endGameSearch(int role){
+	GameSearchRun &run = game_search_runs[role];
+	if(run.search_id != 0){
+		run.ended_searches.insert(run.search_id);
+	}
+	if(SteamGameSearch() == NULL){
+		return;
+	}
+	if(role == GAME_SEARCH_ROLE_PLAYER){
+		SteamGameSearch()->EndGameSearch();
+	}
+	else{
+		SteamGameSearch()->CancelRequestPlayersForGame();
+	}
+}
+
+// Does a callback belong to the running attempt; ones from ended attempts, or for another search once the ID is known, are ignored.
+bool Steam::isCurrentGameSearch(int role, uint64_t search_id){
+	const GameSearchRun &run = game_search_runs[role];
+	if(run.ended_searches.count(search_id) > 0){
+		return false;
+	}
+	return run.search_id == 0 || run.search_id == search_id;
+}
+
+// Change a search's state and send it with its details; any extra details are merged in.
+void Steam::setGameSearchState(int role, int state, Dictionary details){
+	GameSearchRun &run = game_search_runs[role];
+	run.state = state;
+	if(state == GAME_SEARCH_STATE_FOUND && run.accept_deadline == 0){
+		float accept_timeout = run.settings.get("accept_timeout", 30.0);
+		if(accept_timeout > 0){
+			run.accept_deadline = OS::get_singleton()->get_ticks_usec() + (uint64_t)(accept_timeout * 1000000);
+		}
+	}
+	else if(state != GAME_SEARCH_STATE_FOUND){
+		run.accept_deadline = 0;
+	}
+	// Only waiting states need the per-frame update
+	game_search_timed = false;
+	for(int i = 0; i < 2; i++){
+		if(game_search_runs[i].state == GAME_SEARCH_STATE_WAITING_RETRY || (game_search_runs[i].state == GAME_SEARCH_STATE_FOUND && game_search_runs[i].accept_deadline != 0)){
+			game_search_timed = true;
+		}
+	}
+	Dictionary status = gameSearchDetails(role);
+	Array keys = details.keys();
+	for(int i = 0; i < keys.size(); i++){
+		status[keys[i]] = details[keys[i]];
+	}
+	emit_signal("game_search_state", role, state, status);
+}
+
+Dictionary Steam::gameSearchDetails(int role){
+	const GameSearchRun &run = game_search_runs[role];
+	Dictionary status;
+	status["state"] = run.state;
+	status["attempt"] = run.attempt;
+	status["search_id"] = run.search_id;
+	status["game_id"] = run.game_id;
+	status["host_id"] = run.host_id;
+	if(role == GAME_SEARCH_ROLE_HOST){
+		Array players;
+		int accepted = 0;
+		int declined = 0;
+		for(std::map<uint64_t, GameSearchPlayer>::const_iterator player = run.players.begin(); player != run.players.end(); ++player){
+			Dictionary entry;
+			entry["player_id"] = player->first;
+			entry["lobby_id"] = player->second.lobby_id;
+			entry["accept_state"] = player->second.accept_state;
+			entry["team"] = player->second.team;
+			players.append(entry);
+			if(player->second.accept_state == RequestPlayersForGameResultCallback_t::k_EStatePlayerAccepted){
+				accepted++;
+			}
+			else if(player->second.accept_state == RequestPlayersForGameResultCallback_t::k_EStatePlayerDeclined){
+				declined++;
+			}
+		}
+		status["players"] = players;
+		status["accepted"] = accepted;
+		status["declined"] = declined;
+	}
+	return status;
+}
+
+// Start retries that are due and retry games not accepted in time.
+void Steam::updateGameSearch(){
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+	for(int role = 0; role < 2; role++){
+		GameSearchRun &run = game_search_runs[role];
+		if(run.state == GAME_SEARCH_STATE_WAITING_RETRY && now >= run.retry_at){
+			if(SteamGameSearch() == NULL){
+				Dictionary details;
+				details["reason"] = "offline";
+				setGameSearchState(role, GAME_SEARCH_STATE_FAILED, details);
+			}
+			else{
+				launchGameSearch(role);
+			}
+		}
+		else if(run.state == GAME_SEARCH_STATE_FOUND && run.accept_deadline != 0 && now >= run.accept_deadline){
+			if(role == GAME_SEARCH_ROLE_PLAYER && SteamGameSearch() != NULL){
+				SteamGameSearch()->DeclineGame();
+			}
+			retryGameSearch(role, "accept_timeout");
+		}
+	}
+}
+
 
 /////////////////////////////////////////////////
 ///// HTML SURFACE
@@ -2105,6 +3036,32 @@ void Steam::viewSource(uint32 this_handle){
 	}
 }
 
+// Send paints of this browser straight into the given texture.
+void Steam::registerHTMLTexture(uint32 this_handle, SteamHTMLTexture* texture){
+	html_textures[this_handle] = texture;
+}
+
+// Stop painting into a texture, if it is still the one registered for this browser.
+void Steam::unregisterHTMLTexture(uint32 this_handle, SteamHTMLTexture* texture){
+	std::map<uint32, SteamHTMLTexture*>::iterator registered = html_textures.find(this_handle);
+	if(registered != html_textures.end() && registered->second == texture){
+		html_textures.erase(registered);
+	}
+}
+
+// Let a SteamHTMLRect answer the requests of the browser it owns.
+void Steam::registerHTMLRect(uint32 this_handle, SteamHTMLRect* rect){
+	html_rects[this_handle] = rect;
+}
+
+// Stop passing requests to a rect, if it is still the one registered for this browser.
+void Steam::unregisterHTMLRect(uint32 this_handle, SteamHTMLRect* rect){
+	std::map<uint32, SteamHTMLRect*>::iterator registered = html_rects.find(this_handle);
+	if(registered != html_rects.end() && registered->second == rect){
+		html_rects.erase(registered);
+	}
+}
+
 
 /////////////////////////////////////////////////
 ///// HTTP
@@ -3350,9 +4307,13 @@ bool Steam::removeFavoriteGame(uint32 app_id, uint32 ip, uint16 port, uint16 que
 	return SteamMatchmaking()->RemoveFavoriteGame((AppId_t)app_id, ip, port, query_port, flags);
 }
 
-//! Get a list of relevant lobbies.
-void Steam::requestLobbyList(){
+//! Get a list of relevant lobbies. Any metadata keys given are read for every lobby found and delivered with member counts and limits through lobby_match_table.
+void Steam::requestLobbyList(PoolStringArray prefetch_keys){
 	if(SteamMatchmaking() != NULL){
+		lobby_list_prefetch_keys.clear();
+		for(int i = 0; i < prefetch_keys.size(); i++){
+			lobby_list_prefetch_keys.push_back(prefetch_keys[i].utf8());
+		}
 		SteamAPICall_t api_call = SteamMatchmaking()->RequestLobbyList();
 		callResultLobbyList.Set(api_call, this, &Steam::lobby_match_list);
 	}
@@ -3411,6 +4372,77 @@ void Steam::addRequestLobbyListResultCountFilter(int max_results){
 	}
 }
 
+//! Score and sort lobbies from a lobby list, best first. Weights may set ping_key (a lobby key holding a ping location string from convertPingLocationToString), ping_weight (score lost per millisecond), ping_default (milliseconds assumed when no estimate is possible), max_ping (drop lobbies estimated above this), skill_key, skill_target and skill_weight (score lost per unit of skill difference) and fill_weight (score gained for a full lobby, scaled by how full it is). Full lobbies are always dropped.
+Dictionary Steam::rankLobbies(Array lobby_ids, Dictionary weights){
+	Dictionary ranking;
+	if(SteamMatchmaking() == NULL){
+		return ranking;
+	}
+	CharString ping_key = String(weights.get("ping_key", "")).utf8();
+	float ping_weight = weights.get("ping_weight", 0.0);
+	int ping_default = weights.get("ping_default", LOBBY_RANK_DEFAULT_PING);
+	int max_ping = weights.get("max_ping", 0);
+	CharString skill_key = String(weights.get("skill_key", "")).utf8();
+	float skill_target = weights.get("skill_target", 0.0);
+	float skill_weight = weights.get("skill_weight", 0.0);
+	float fill_weight = weights.get("fill_weight", 0.0);
+	bool use_ping = ping_key.length() > 0 && SteamNetworkingUtils() != NULL;
+	std::vector<LobbyRank> ranks;
+	ranks.reserve(lobby_ids.size());
+	for(int i = 0; i < lobby_ids.size(); i++){
+		LobbyRank rank;
+		rank.lobby_id = lobby_ids[i];
+		CSteamID lobby_id = (uint64)rank.lobby_id;
+		int members = SteamMatchmaking()->GetNumLobbyMembers(lobby_id);
+		int limit = SteamMatchmaking()->GetLobbyMemberLimit(lobby_id);
+		if(limit > 0 && members >= limit){
+			continue;
+		}
+		rank.ping = ping_default;
+		if(use_ping){
+			SteamNetworkPingLocation_t location;
+			const char* location_string = SteamMatchmaking()->GetLobbyData(lobby_id, ping_key.get_data());
+			if(location_string[0] != '\0' && SteamNetworkingUtils()->ParsePingLocationString(location_string, location)){
+				int estimate = SteamNetworkingUtils()->EstimatePingTimeFromLocalHost(location);
+				if(estimate >= 0){
+					rank.ping = estimate;
+				}
+			}
+			if(max_ping > 0 && rank.ping > max_ping){
+				continue;
+			}
+		}
+		rank.score = -ping_weight * rank.ping;
+		if(skill_key.length() > 0){
+			float skill = String::utf8(SteamMatchmaking()->GetLobbyData(lobby_id, skill_key.get_data())).to_float();
+			rank.score -= skill_weight * fabsf(skill - skill_target);
+		}
+		if(limit > 0){
+			rank.score += fill_weight * members / (float)limit;
+		}
+		ranks.push_back(rank);
+	}
+	std::stable_sort(ranks.begin(), ranks.end());
+	Array ranked_ids;
+	PoolRealArray scores;
+	PoolIntArray pings;
+	scores.resize(ranks.size());
+	pings.resize(ranks.size());
+	{
+		PoolRealArray::Write scores_write = scores.write();
+		PoolIntArray::Write pings_write = pings.write();
+		for(uint32_t i = 0; i < ranks.size(); i++){
+			ranked_ids.append((uint64_t)ranks[i].lobby_id);
+			scores_write[i] = ranks[i].score;
+			pings_write[i] = ranks[i].ping;
+		}
+	}
+	ranking["lobby_ids"] = ranked_ids;
+	ranking["scores"] = scores;
+	ranking["pings"] = pings;
+	return ranking;
+}
+
 //! Create a lobby on the Steam servers, if private the lobby will not be returned by any RequestLobbyList() call.
 void Steam::createLobby(LobbyType lobby_type, int max_members){
 	if(SteamMatchmaking() != NULL){
@@ -3433,6 +4465,7 @@ void Steam::leaveLobby(uint64_t steam_lobby_id){
 		CSteamID lobby_id = (uint64)steam_lobby_id;
 		SteamMatchmaking()->LeaveLobby(lobby_id);
 	}
+	lobby_mirrors.erase(steam_lobby_id);
 }
 
 //! Invite another user to the lobby, the target user will receive a LobbyInvite_t callback, will return true if the invite is successfully sent, whether or not the target responds.
@@ -3464,22 +4497,40 @@ uint64_t Steam::getLobbyMemberByIndex(uint64_t steam_lobby_id, int member){
 	return lobbyMember.ConvertToUint64();
 }
 
-//! Get data associated with this lobby.
+//! Get data associated with this lobby. Joined lobbies are read from the lobby data mirror.
 String Steam::getLobbyData(uint64_t steam_lobby_id, const String& key){
 	if(SteamMatchmaking() == NULL){
 		return "";
 	}
+	std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(steam_lobby_id);
+	if(mirror != lobby_mirrors.end()){
+		std::map<String, String>::iterator value = mirror->second.data.find(key);
+		return (value != mirror->second.data.end()) ? value->second : "";
+	}
 	CSteamID lobby_id = (uint64)steam_lobby_id;
 	return String::utf8(SteamMatchmaking()->GetLobbyData(lobby_id, key.utf8().get_data()));
 }
 
-//! Sets a key/value pair in the lobby metadata.
+//! Sets a key/value pair in the lobby metadata. Joined lobbies update their data mirror right away and send lobby_data_changed if the value changed, since the data update that follows will find nothing new.
 bool Steam::setLobbyData(uint64_t steam_lobby_id, const String& key, const String& value){
 	if(SteamMatchmaking() == NULL){
 		return false;
 	}
 	CSteamID lobby_id = (uint64)steam_lobby_id;
-	return SteamMatchmaking()->SetLobbyData(lobby_id, key.utf8().get_data(), value.utf8().get_data());
+	if(!SteamMatchmaking()->SetLobbyData(lobby_id, key.utf8().get_data(), value.utf8().get_data())){
+		return false;
+	}
+	std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(steam_lobby_id);
+	if(mirror != lobby_mirrors.end()){
+		std::map<String, String>::iterator old_value = mirror->second.data.find(key);
+		if(old_value == mirror->second.data.end() || old_value->second != value){
+			mirror->second.data[key] = value;
+			PoolStringArray keys;
+			keys.append(key);
+			emit_signal("lobby_data_changed", steam_lobby_id, steam_lobby_id, keys);
+		}
+	}
+	return true;
 }
 
 //! Get lobby data by the lobby's ID
@@ -3503,31 +4554,138 @@ Dictionary Steam::getAllLobbyData(uint64_t steam_lobby_id){
 	return data;
 }
 
-//! Removes a metadata key from the lobby.
+//! Get the mirrored lobby data of a joined lobby as a dictionary of its data and a dictionary of each member's data for the keys set with setLobbyMemberDataKeys. Returns an empty dictionary for lobbies not joined.
+Dictionary Steam::getLobbyDataMirror(uint64_t steam_lobby_id){
+	Dictionary lobby;
+	std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(steam_lobby_id);
+	if(mirror == lobby_mirrors.end()){
+		return lobby;
+	}
+	Dictionary data;
+	for(std::map<String, String>::iterator key = mirror->second.data.begin(); key != mirror->second.data.end(); ++key){
+		data[key->first] = key->second;
+	}
+	Dictionary members;
+	for(std::map<uint64_t, std::map<String, String>>::iterator member = mirror->second.members.begin(); member != mirror->second.members.end(); ++member){
+		Dictionary member_data;
+		for(std::map<String, String>::iterator key = member->second.begin(); key != member->second.end(); ++key){
+			member_data[key->first] = key->second;
+		}
+		members[(uint64_t)member->first] = member_data;
+	}
+	lobby["data"] = data;
+	lobby["members"] = members;
+	return lobby;
+}
+
+//! Removes a metadata key from the lobby. Joined lobbies update their data mirror right away and send lobby_data_changed if the key was set.
 bool Steam::deleteLobbyData(uint64_t steam_lobby_id, const String& key){
 	if(SteamMatchmaking() == NULL){
 		return false;
 	}
 	CSteamID lobby_id = (uint64)steam_lobby_id;
-	return SteamMatchmaking()->DeleteLobbyData(lobby_id, key.utf8().get_data());
+	if(!SteamMatchmaking()->DeleteLobbyData(lobby_id, key.utf8().get_data())){
+		return false;
+	}
+	std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(steam_lobby_id);
+	if(mirror != lobby_mirrors.end() && mirror->second.data.erase(key) > 0){
+		PoolStringArray keys;
+		keys.append(key);
+		emit_signal("lobby_data_changed", steam_lobby_id, steam_lobby_id, keys);
+	}
+	return true;
 }
 
-//! Gets per-user metadata for someone in this lobby.
+//! Gets per-user metadata for someone in this lobby. Keys set with setLobbyMemberDataKeys are read from the lobby data mirror in joined lobbies.
 String Steam::getLobbyMemberData(uint64_t steam_lobby_id, uint64_t steam_id_user, const String& key){
 	if(SteamMatchmaking() == NULL){
 		return "";
 	}
-	CSteamID lobby_id = (uint64)steam_lobby_id;
+	std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(steam_lobby_id);
+	if(mirror != lobby_mirrors.end()){
+		std::map<uint64_t, std::map<String, String>>::iterator member = mirror->second.members.find(steam_id_user);
+		if(member != mirror->second.members.end()){
+			std::map<String, String>::iterator value = member->second.find(key);
+			if(value != member->second.end()){
+				return value->second;
+			}
+		}
+	}
+	CSteamID lobby_id = (uint64)steam_lobby_id;
 	CSteamID user_id = (uint64)steam_id_user;
 	return SteamMatchmaking()->GetLobbyMemberData(lobby_id, user_id, key.utf8().get_data());
 }
 
-//! Sets per-user metadata (for the local user implicitly).
+//! Sets per-user metadata (for the local user implicitly). Keys set with setLobbyMemberDataKeys update the local user's mirrored data in joined lobbies right away and send lobby_data_changed if the value changed.
 void Steam::setLobbyMemberData(uint64_t steam_lobby_id, const String& key, const String& value){
 	if(SteamMatchmaking() != NULL){
 		CSteamID lobby_id = (uint64)steam_lobby_id;
-		SteamMatchmaking()->SetLobbyMemberData(lobby_id, key.utf8().get_data(), value.utf8().get_data());
+		CharString key_utf8 = key.utf8();
+		SteamMatchmaking()->SetLobbyMemberData(lobby_id, key_utf8.get_data(), value.utf8().get_data());
+		std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(steam_lobby_id);
+		if(mirror == lobby_mirrors.end() || SteamUser() == NULL){
+			return;
+		}
+		for(uint32_t i = 0; i < lobby_member_data_keys.size(); i++){
+			if(strcmp(lobby_member_data_keys[i].get_data(), key_utf8.get_data()) == 0){
+				uint64_t member_id = SteamUser()->GetSteamID().ConvertToUint64();
+				std::map<String, String> &member = mirror->second.members[member_id];
+				std::map<String, String>::iterator old_value = member.find(key);
+				if(old_value == member.end() || old_value->second != value){
+					member[key] = value;
+					PoolStringArray keys;
+					keys.append(key);
+					emit_signal("lobby_data_changed", steam_lobby_id, member_id, keys);
+				}
+				break;
+			}
+		}
+	}
+}
+
+//! Set which member data keys the lobby data mirror keeps for every member; Steam cannot list a member's keys, so only these are mirrored.
+void Steam::setLobbyMemberDataKeys(PoolStringArray keys){
+	lobby_member_data_keys.clear();
+	for(int i = 0; i < keys.size(); i++){
+		lobby_member_data_keys.push_back(keys[i].utf8());
+	}
+	// Re-read members of joined lobbies so the mirror matches the new keys
+	for(std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.begin(); mirror != lobby_mirrors.end(); ++mirror){
+		for(std::map<uint64_t, std::map<String, String>>::iterator member = mirror->second.members.begin(); member != mirror->second.members.end(); ++member){
+			std::set<String> changed;
+			mirrorLobbyMemberData(mirror->first, member->first, changed);
+		}
+	}
+}
+
+// Re-read a joined lobby's data into its mirror, noting the keys that changed.
+void Steam::mirrorLobbyData(uint64_t lobby_id, std::set<String>& changed){
+	CSteamID steam_lobby_id = (uint64)lobby_id;
+	std::map<String, String> data;
+	int data_count = SteamMatchmaking()->GetLobbyDataCount(steam_lobby_id);
+	char key[MAX_LOBBY_KEY_LENGTH];
+	char value[CHAT_METADATA_MAX];
+	for(int i = 0; i < data_count; i++){
+		if(SteamMatchmaking()->GetLobbyDataByIndex(steam_lobby_id, i, key, MAX_LOBBY_KEY_LENGTH, value, CHAT_METADATA_MAX)){
+			data[String::utf8(key)] = String::utf8(value);
+		}
 	}
+	LobbyMirror &mirror = lobby_mirrors[lobby_id];
+	diffKeyValues(mirror.data, data, changed);
+	mirror.data.swap(data);
+}
+
+// Re-read a member's mirrored keys, noting the keys that changed.
+void Steam::mirrorLobbyMemberData(uint64_t lobby_id, uint64_t member_id, std::set<String>& changed){
+	CSteamID steam_lobby_id = (uint64)lobby_id;
+	CSteamID user_id = (uint64)member_id;
+	std::map<String, String> data;
+	for(uint32_t i = 0; i < lobby_member_data_keys.size(); i++){
+		data[String::utf8(lobby_member_data_keys[i].get_data())] = String::utf8(SteamMatchmaking()->GetLobbyMemberData(steam_lobby_id, user_id, lobby_member_data_keys[i].get_data()));
+	}
+	std::map<String, String> &mirrored = lobby_mirrors[lobby_id].members[member_id];
+	diffKeyValues(mirrored, data, changed);
+	mirrored.swap(data);
 }
 
 //! Broadcasts a chat message to the all the users in the lobby.
@@ -3539,6 +4697,69 @@ bool Steam::sendLobbyChatMsg(uint64_t steam_lobby_id, const String& message_body
 	return SteamMatchmaking()->SendLobbyChatMsg(lobby_id, message_body.utf8().get_data(), strlen(message_body.utf8().get_data()) + 1);
 }
 
+//! Broadcasts binary data to all the users in the lobby; it arrives through lobby_message_binary instead of lobby_message.
+bool Steam::sendLobbyChatBinary(uint64_t steam_lobby_id, PoolByteArray data){
+	if(SteamMatchmaking() == NULL){
+		return false;
+	}
+	PoolByteArray::Read data_read = data.read();
+	return sendLobbyChatFrame(steam_lobby_id, LOBBY_CHAT_FRAME_BINARY, data_read.ptr(), data.size());
+}
+
+//! Add a small binary message to the lobby's outgoing batch. Batches are sent as one chat entry at the end of the frame, or sooner if the next message would not fit; each message still arrives separately through lobby_message_binary.
+bool Steam::queueLobbyChatBinary(uint64_t steam_lobby_id, PoolByteArray data){
+	if(SteamMatchmaking() == NULL){
+		return false;
+	}
+	// Each message carries a two byte length after the two byte frame header
+	if(data.size() == 0 || data.size() > LOBBY_CHAT_MESSAGE_MAX - 4){
+		printf("[Steam] Lobby chat message of %d bytes cannot be batched.\n", data.size());
+		return false;
+	}
+	std::vector<uint8_t>* batch = &lobby_chat_batches[steam_lobby_id];
+	if(!batch->empty() && 2 + batch->size() + 2 + data.size() > LOBBY_CHAT_MESSAGE_MAX){
+		flushLobbyChat(steam_lobby_id);
+		batch = &lobby_chat_batches[steam_lobby_id];
+	}
+	PoolByteArray::Read data_read = data.read();
+	batch->push_back(data.size() & 0xFF);
+	batch->push_back((data.size() >> 8) & 0xFF);
+	batch->insert(batch->end(), data_read.ptr(), data_read.ptr() + data.size());
+	return true;
+}
+
+//! Send the outgoing lobby chat batch of one lobby now, or of every lobby if no lobby is given.
+void Steam::flushLobbyChat(uint64_t steam_lobby_id){
+	std::map<uint64_t, std::vector<uint8_t>>::iterator batch = (steam_lobby_id == 0) ? lobby_chat_batches.begin() : lobby_chat_batches.find(steam_lobby_id);
+	while(batch != lobby_chat_batches.end()){
+		if(!batch->second.empty() && SteamMatchmaking() != NULL){
+			if(!sendLobbyChatFrame(batch->first, LOBBY_CHAT_FRAME_BATCH, &batch->second[0], batch->second.size())){
+				printf("[Steam] Failed to send lobby chat batch.\n");
+			}
+		}
+		lobby_chat_batches.erase(batch++);
+		if(steam_lobby_id != 0){
+			break;
+		}
+	}
+}
+
+// Send binary lobby chat behind a zero byte, which no text message can start with, and a byte saying how to read the rest.
+bool Steam::sendLobbyChatFrame(uint64_t lobby_id, uint8_t kind, const uint8_t* data, uint32_t size){
+	if(size > LOBBY_CHAT_MESSAGE_MAX - 2){
+		printf("[Steam] Lobby chat message of %d bytes is too large.\n", size);
+		return false;
+	}
+	uint8_t frame[LOBBY_CHAT_MESSAGE_MAX];
+	frame[0] = 0;
+	frame[1] = kind;
+	if(size > 0){
+		memcpy(frame + 2, data, size);
+	}
+	CSteamID steam_lobby_id = (uint64)lobby_id;
+	return SteamMatchmaking()->SendLobbyChatMsg(steam_lobby_id, frame, size + 2);
+}
+
 //! Refreshes metadata for a lobby you're not necessarily in right now.
 bool Steam::requestLobbyData(uint64_t steam_lobby_id){
 	if(SteamMatchmaking() == NULL){
@@ -3675,13 +4896,21 @@ void Steam::cancelQuery(uint64_t this_server_list_request){
 	}
 }
 
-//! Cancel an outstanding individual server query.
+//! Cancel an outstanding individual server query. Handles of the query scheduler's most recently finished queries are ignored.
 void Steam::cancelServerQuery(int server_query){
+	if(server_queries.cancel((HServerQuery)server_query) || server_queries.was_reaped((HServerQuery)server_query)){
+		return;
+	}
 	if(SteamMatchmakingServers() != NULL){
 		SteamMatchmakingServers()->CancelServerQuery((HServerQuery)server_query);
 	}
 }
 
+//! Drop every queued server query that has not started yet. Queries already running still finish.
+void Steam::cancelServerQueries(){
+	server_queries.cancel_pending();
+}
+
 //! Gets the number of servers in the given list.
 int Steam::getServerCount(uint64_t this_server_list_request){
 	if(SteamMatchmakingServers() == NULL){
@@ -3703,30 +4932,37 @@ Dictionary Steam::getServerDetails(int server, uint64_t this_server_list_request
 		if(this_server_list_request == 0){
 			this_server_list_request = (uint64)server_list_request;
 		}
-		gameserveritem_t* server_item = new gameserveritem_t;
-		SteamMatchmakingServers()->GetServerDetails((HServerListRequest)this_server_list_request, server);
-		// Populate the dictionary
-		game_server["ping"] = server_item->m_nPing;
-		game_server["success_response"] = server_item->m_bHadSuccessfulResponse;
-		game_server["no_refresh"] = server_item->m_bDoNotRefresh;
-		game_server["game_dir"] = server_item->m_szGameDir;
-		game_server["map"] = server_item->m_szMap;
-		game_server["description"] = server_item->m_szGameDescription;
-		game_server["app_id"] = server_item->m_nAppID;
-		game_server["players"] = server_item->m_nPlayers;
-		game_server["max_players"] = server_item->m_nMaxPlayers;
-		game_server["bot_players"] = server_item->m_nBotPlayers;
-		game_server["password"] = server_item->m_bPassword;
-		game_server["secure"] = server_item->m_bSecure;
-		game_server["last_played"] = server_item->m_ulTimeLastPlayed;
-		game_server["server_version"] = server_item->m_nServerVersion;
-		// Clean up
-		delete server_item;
+		// The item belongs to Steam and stays valid until the list is released or refreshed
+		gameserveritem_t* server_item = SteamMatchmakingServers()->GetServerDetails((HServerListRequest)this_server_list_request, server);
+		if(server_item != NULL){
+			game_server = SteamServerList::item_to_dictionary(*server_item);
+		}
 	}
 	// Return the dictionary
 	return game_server;
 }
 
+//! Get how many servers of the internal server list pass the filter set with setServerListFilter.
+int Steam::getServerListCount(){
+	return server_list.get_count();
+}
+
+//! Get a window of the internal server list, filtered and sorted, for a virtualized list. Only the servers in the window are converted to dictionaries. Servers from the cache that failed to respond keep their cached details and have "stale" set.
+Array Steam::getServerListPage(int offset, int count){
+	if(offset < 0 || count <= 0){
+		return Array();
+	}
+	return server_list.get_page(offset, count);
+}
+
+//! Get how many server queries are queued and how many are running.
+Dictionary Steam::getServerQueryStatus(){
+	Dictionary status;
+	status["pending"] = server_queries.get_pending_count();
+	status["in_flight"] = server_queries.get_in_flight_count();
+	return status;
+}
+
 //! Returns true if the list is currently refreshing its server list.
 bool Steam::isRefreshing(uint64_t this_server_list_request){
 	if(SteamMatchmakingServers() == NULL){
@@ -3744,20 +4980,13 @@ int Steam::pingServer(const String& ip, uint16 port){
 	if(SteamMatchmakingServers() == NULL){
 		return 0;
 	}
-	// Resolve address and convert it from IP_Address string to uint32_t
-	IP_Address address;
-	if(ip.is_valid_ip_address()){
-		address = ip;
-	}
-	else{
-		address = IP::get_singleton()->resolve_hostname(ip, IP::TYPE_IPV4);
-	}
+	uint32_t ip4 = resolveServerAddress(ip);
 	// Resolution failed
-	if(!address.is_valid()){
+	if(ip4 == 0){
 		return 0;
 	}
-	uint32_t ip4 = *((uint32_t *)address.get_ipv4());
-	return SteamMatchmakingServers()->PingServer(ip4, port, ping_response);
+	// Results arrive through server_query_complete
+	return server_queries.start(ip4, port, SERVER_QUERY_PING);
 }
 
 //! Request the list of players currently playing on a server.
@@ -3765,20 +4994,22 @@ int Steam::playerDetails(const String& ip, uint16 port){
 	if(SteamMatchmakingServers() == NULL){
 		return 0;
 	}
-	// Resolve address and convert it from IP_Address string to uint32_t
-	IP_Address address;
-	if(ip.is_valid_ip_address()){
-		address = ip;
-	}
-	else{
-		address = IP::get_singleton()->resolve_hostname(ip, IP::TYPE_IPV4);
-	}
+	uint32_t ip4 = resolveServerAddress(ip);
 	// Resolution failed
-	if(!address.is_valid()){
+	if(ip4 == 0){
 		return 0;
 	}
-	uint32_t ip4 = *((uint32_t *)address.get_ipv4());
-	return SteamMatchmakingServers()->PlayerDetails(ip4, port, player_response);
+	// Results arrive through server_query_complete
+	return server_queries.start(ip4, port, SERVER_QUERY_PLAYERS);
+}
+
+//! Queue ping, players and / or rules queries (SERVER_QUERY_* flags) for a server. Higher priorities start first; queue a server again to change its priority, such as when its row scrolls into view. Each server's results arrive together through server_query_complete.
+bool Steam::queueServerQuery(const String& ip, uint16 port, int kinds, int priority){
+	uint32_t ip4 = resolveServerAddress(ip);
+	if(ip4 == 0){
+		return false;
+	}
+	return server_queries.queue(ip4, port, kinds, priority);
 }
 
 //! Ping every server in your list again but don't update the list of servers. Query callback installed when the server list was requested will be used again to post notifications and RefreshComplete, so the callback must remain valid until another RefreshComplete is called on it or the request is released with ReleaseRequest( hRequest ).
@@ -3815,137 +5046,59 @@ void Steam::releaseRequest(uint64_t this_server_list_request){
 }
 
 //! Request a new list of servers of a particular type.  These calls each correspond to one of the EMatchMakingType values.
-uint64_t Steam::requestFavoritesServerList(uint32 app_id, Array filters){
+uint64_t Steam::requestFavoritesServerList(uint32 app_id, Variant filters){
 	server_list_request = 0;
 	if(SteamMatchmakingServers() != NULL){
-		uint32 filter_size = filters.size();
-		MatchMakingKeyValuePair_t* filters_array = new MatchMakingKeyValuePair_t[filter_size];
-		for (uint32 i=0; i < filter_size; i++){
-			// Create a new filter pair to populate
-			MatchMakingKeyValuePair_t *filter_array = new MatchMakingKeyValuePair_t();
-			// Get the key/value pair
-			Array pair = filters[i];
-			// Get the key from the filter pair
-			String key = (String)pair[0];
-			char *this_key = new char[256];
-			strcpy(this_key, key.utf8().get_data());
-			filter_array->m_szKey[i] = *this_key;
-			delete[] this_key;
-			// Get the value from the filter pair
-			String value = pair[1];
-			char *this_value = new char[256];
-			strcpy(this_value, value.utf8().get_data());
-			filter_array->m_szValue[i] = *this_value;
-			delete[] this_value;
-			// Append this to the array
-			filters_array[i] = *filter_array;
-			// Free up the memory
-			delete filter_array;
-		}
+		Ref<SteamServerFilter> server_filter = getServerFilter(filters);
+		uint32 filter_size = 0;
+		MatchMakingKeyValuePair_t* filters_array = server_filter->get_pairs(filter_size);
 		server_list_request = SteamMatchmakingServers()->RequestFavoritesServerList((AppId_t)app_id, &filters_array, filter_size, server_list_response);
-		delete[] filters_array;
+		server_list.set_request(server_list_request);
+		if(!server_list_cache.empty()){
+			server_list.use_cache(server_list_cache + "_favorites_" + itos(app_id) + ".idx");
+		}
 	}
 	return (uint64)server_list_request;
 }
 
 //! Request a new list of servers of a particular type.  These calls each correspond to one of the EMatchMakingType values.
-uint64_t Steam::requestFriendsServerList(uint32 app_id, Array filters){
+uint64_t Steam::requestFriendsServerList(uint32 app_id, Variant filters){
 	server_list_request = 0;
 	if(SteamMatchmakingServers() != NULL){
-		uint32 filter_size = filters.size();
-		MatchMakingKeyValuePair_t* filters_array = new MatchMakingKeyValuePair_t[filter_size];
-		for (uint32 i=0; i < filter_size; i++){
-			// Create a new filter pair to populate
-			MatchMakingKeyValuePair_t *filter_array = new MatchMakingKeyValuePair_t();
-			// Get the key/value pair
-			Array pair = filters[i];
-			// Get the key from the filter pair
-			String key = (String)pair[0];
-			char *this_key = new char[256];
-			strcpy(this_key, key.utf8().get_data());
-			filter_array->m_szKey[i] = *this_key;
-			delete[] this_key;
-			// Get the value from the filter pair
-			String value = pair[1];
-			char *this_value = new char[256];
-			strcpy(this_value, value.utf8().get_data());
-			filter_array->m_szValue[i] = *this_value;
-			delete[] this_value;
-			// Append this to the array
-			filters_array[i] = *filter_array;
-			// Free up the memory
-			delete filter_array;
-		}
+		Ref<SteamServerFilter> server_filter = getServerFilter(filters);
+		uint32 filter_size = 0;
+		MatchMakingKeyValuePair_t* filters_array = server_filter->get_pairs(filter_size);
 		server_list_request = SteamMatchmakingServers()->RequestFriendsServerList((AppId_t)app_id, &filters_array, filter_size, server_list_response);
-		delete[] filters_array;
+		server_list.set_request(server_list_request);
 	}
 	return (uint64)server_list_request;
 }
 
 //! Request a new list of servers of a particular type.  These calls each correspond to one of the EMatchMakingType values.
-uint64_t Steam::requestHistoryServerList(uint32 app_id, Array filters){
+uint64_t Steam::requestHistoryServerList(uint32 app_id, Variant filters){
 	server_list_request = 0;
 	if(SteamMatchmakingServers() != NULL){
-		uint32 filter_size = filters.size();
-		MatchMakingKeyValuePair_t* filters_array = new MatchMakingKeyValuePair_t[filter_size];
-		for (uint32 i=0; i < filter_size; i++){
-			// Create a new filter pair to populate
-			MatchMakingKeyValuePair_t *filter_array = new MatchMakingKeyValuePair_t();
-			// Get the key/value pair
-			Array pair = filters[i];
-			// Get the key from the filter pair
-			String key = (String)pair[0];
-			char *this_key = new char[256];
-			strcpy(this_key, key.utf8().get_data());
-			filter_array->m_szKey[i] = *this_key;
-			delete[] this_key;
-			// Get the value from the filter pair
-			String value = pair[1];
-			char *this_value = new char[256];
-			strcpy(this_value, value.utf8().get_data());
-			filter_array->m_szValue[i] = *this_value;
-			delete[] this_value;
-			// Append this to the array
-			filters_array[i] = *filter_array;
-			// Free up the memory
-			delete filter_array;
-		}
+		Ref<SteamServerFilter> server_filter = getServerFilter(filters);
+		uint32 filter_size = 0;
+		MatchMakingKeyValuePair_t* filters_array = server_filter->get_pairs(filter_size);
 		server_list_request = SteamMatchmakingServers()->RequestHistoryServerList((AppId_t)app_id, &filters_array, filter_size, server_list_response);
-		delete[] filters_array;
+		server_list.set_request(server_list_request);
+		if(!server_list_cache.empty()){
+			server_list.use_cache(server_list_cache + "_history_" + itos(app_id) + ".idx");
+		}
 	}
 	return (uint64)server_list_request;
 }
 
 //! Request a new list of servers of a particular type.  These calls each correspond to one of the EMatchMakingType values.
-uint64_t Steam::requestInternetServerList(uint32 app_id, Array filters){
+uint64_t Steam::requestInternetServerList(uint32 app_id, Variant filters){
 	server_list_request = 0;
 	if(SteamMatchmakingServers() != NULL){
-		uint32 filter_size = filters.size();
-		MatchMakingKeyValuePair_t* filters_array = new MatchMakingKeyValuePair_t[filter_size];
-		for (uint32 i=0; i < filter_size; i++){
-			// Create a new filter pair to populate
-			MatchMakingKeyValuePair_t *filter_array = new MatchMakingKeyValuePair_t();
-			// Get the key/value pair
-			Array pair = filters[i];
-			// Get the key from the filter pair
-			String key = (String)pair[0];
-			char *this_key = new char[256];
-			strcpy(this_key, key.utf8().get_data());
-			filter_array->m_szKey[i] = *this_key;
-			delete[] this_key;
-			// Get the value from the filter pair
-			String value = pair[1];
-			char *this_value = new char[256];
-			strcpy(this_value, value.utf8().get_data());
-			filter_array->m_szValue[i] = *this_value;
-			delete[] this_value;
-			// Append this to the array
-			filters_array[i] = *filter_array;
-			// Free up the memory
-			delete filter_array;
-		}
+		Ref<SteamServerFilter> server_filter = getServerFilter(filters);
+		uint32 filter_size = 0;
+		MatchMakingKeyValuePair_t* filters_array = server_filter->get_pairs(filter_size);
 		server_list_request = SteamMatchmakingServers()->RequestInternetServerList((AppId_t)app_id, &filters_array, filter_size, server_list_response);
-		delete[] filters_array;
+		server_list.set_request(server_list_request);
 	}
 	return (uint64)server_list_request;
 }
@@ -3955,40 +5108,20 @@ uint64_t Steam::requestLANServerList(uint32 app_id){
 	server_list_request = 0;
 	if(SteamMatchmakingServers() != NULL){
 		server_list_request = SteamMatchmakingServers()->RequestLANServerList((AppId_t)app_id, server_list_response);
+		server_list.set_request(server_list_request);
 	}
 	return (uint64)server_list_request;
 }
 
 //! Request a new list of servers of a particular type.  These calls each correspond to one of the EMatchMakingType values.
-uint64_t Steam::requestSpectatorServerList(uint32 app_id, Array filters){
+uint64_t Steam::requestSpectatorServerList(uint32 app_id, Variant filters){
 	server_list_request = 0;
 	if(SteamMatchmakingServers() != NULL){
-		uint32 filter_size = filters.size();
-		MatchMakingKeyValuePair_t* filters_array = new MatchMakingKeyValuePair_t[filter_size];
-		for (uint32 i=0; i < filter_size; i++){
-			// Create a new filter pair to populate
-			MatchMakingKeyValuePair_t *filter_array = new MatchMakingKeyValuePair_t();
-			// Get the key/value pair
-			Array pair = filters[i];
-			// Get the key from the filter pair
-			String key = (String)pair[0];
-			char *this_key = new char[256];
-			strcpy(this_key, key.utf8().get_data());
-			filter_array->m_szKey[i] = *this_key;
-			delete[] this_key;
-			// Get the value from the filter pair
-			String value = pair[1];
-			char *this_value = new char[256];
-			strcpy(this_value, value.utf8().get_data());
-			filter_array->m_szValue[i] = *this_value;
-			delete[] this_value;
-			// Append this to the array
-			filters_array[i] = *filter_array;
-			// Free up the memory
-			delete filter_array;
-		}
+		Ref<SteamServerFilter> server_filter = getServerFilter(filters);
+		uint32 filter_size = 0;
+		MatchMakingKeyValuePair_t* filters_array = server_filter->get_pairs(filter_size);
 		server_list_request = SteamMatchmakingServers()->RequestSpectatorServerList((AppId_t)app_id, &filters_array, filter_size, server_list_response);
-		delete[] filters_array;
+		server_list.set_request(server_list_request);
 	}
 	return (uint64)server_list_request;
 }
@@ -3998,7 +5131,56 @@ int Steam::serverRules(const String& ip, uint16 port){
 	if(SteamMatchmakingServers() == NULL){
 		return 0;
 	}
-	// Resolve address and convert it from IP_Address string to uint32_t
+	uint32_t ip4 = resolveServerAddress(ip);
+	// Resolution failed
+	if(ip4 == 0){
+		return 0;
+	}
+	// Results arrive through server_query_complete
+	return server_queries.start(ip4, port, SERVER_QUERY_RULES);
+}
+
+//! Keep the favorites and history server lists in cache files starting with this path, such as "user://servers". The internal list is filled from them as soon as requestFavoritesServerList or requestHistoryServerList is called and they are saved when the refresh completes successfully. An empty path turns caching off.
+void Steam::setServerListCache(const String& path){
+	server_list_cache = path;
+}
+
+//! Filter the internal server list by max_ping, min_players, hide_full, hide_empty, hide_password, secure_only, hide_unresponsive (on by default), map (part of the map name) and tags (every tag must be present). Keys left out show everything.
+void Steam::setServerListFilter(Dictionary filter){
+	server_list.set_filter(filter);
+}
+
+//! Sort the internal server list by SERVER_SORT_PING, SERVER_SORT_PLAYERS, SERVER_SORT_MAP or SERVER_SORT_NAME.
+void Steam::setServerListSort(int field, bool ascending){
+	server_list.set_sort(field, ascending);
+}
+
+//! Set how many queued server queries may run at once and how many seconds one may run before it is cancelled and reported as failed. A timeout of 0 means queries never time out.
+void Steam::setServerQueryLimits(int max_in_flight, float timeout){
+	server_queries.set_limits(MAX(max_in_flight, 1), (uint64_t)(MAX(timeout, 0.0f) * 1000000));
+}
+
+// Use a SteamServerFilter as is, or build a temporary one from an array of [key, value] pairs, kept verbatim and in order.
+Ref<SteamServerFilter> Steam::getServerFilter(const Variant& filters){
+	Ref<SteamServerFilter> server_filter = filters;
+	if(server_filter.is_valid()){
+		return server_filter;
+	}
+	server_filter.instance();
+	if(filters.get_type() == Variant::ARRAY){
+		Array pairs = filters;
+		for(int i = 0; i < pairs.size(); i++){
+			Array pair = pairs[i];
+			if(pair.size() >= 2){
+				server_filter->add_filter(pair[0], pair[1]);
+			}
+		}
+	}
+	return server_filter;
+}
+
+// Resolve a server address to the host order IPv4 Steam expects, or 0 if it cannot be resolved.
+uint32_t Steam::resolveServerAddress(const String& ip){
 	IP_Address address;
 	if(ip.is_valid_ip_address()){
 		address = ip;
@@ -4006,12 +5188,29 @@ int Steam::serverRules(const String& ip, uint16 port){
 	else{
 		address = IP::get_singleton()->resolve_hostname(ip, IP::TYPE_IPV4);
 	}
-	// Resolution failed
-	if(!address.is_valid()){
+	if(!address.is_valid() || !address.is_ipv4()){
 		return 0;
 	}
-	uint32_t ip4 = *((uint32_t *)address.get_ipv4());
-	return SteamMatchmakingServers()->ServerRules(ip4, port, rules_response);
+	const uint8_t* octets = address.get_ipv4();
+	return ((uint32_t)octets[0] << 24) | ((uint32_t)octets[1] << 16) | ((uint32_t)octets[2] << 8) | octets[3];
+}
+
+// Tell script once per frame that servers were added to or updated in the internal server list.
+void Steam::updateServerList(){
+	if(server_list.take_changed()){
+		emit_signal("server_list_updated", server_list.get_total());
+	}
+}
+
+// Reap finished and timed out server queries, start queued ones and send each finished server's results.
+void Steam::updateServerQueries(){
+	std::vector<SteamServerQueries::Result> completed;
+	server_queries.update(OS::get_singleton()->get_ticks_usec(), completed);
+	for(uint32_t i = 0; i < completed.size(); i++){
+		uint32_t ip = completed[i].ip;
+		String address = itos((ip >> 24) & 0xFF) + "." + itos((ip >> 16) & 0xFF) + "." + itos((ip >> 8) & 0xFF) + "." + itos(ip & 0xFF);
+		emit_signal("server_query_complete", address, completed[i].port, completed[i].data);
+	}
 }
 
 
@@ -4464,7 +5663,12 @@ bool Steam::acceptSessionWithUser(const String& identity_reference){
 	if(SteamNetworkingMessages() == NULL){
 		return false;
 	}
-	return SteamNetworkingMessages()->AcceptSessionWithUser(networking_identities[identity_reference.utf8().get_data()]);
+	const SteamNetworkingIdentity &identity = networking_identities[identity_reference.utf8().get_data()];
+	bool success = SteamNetworkingMessages()->AcceptSessionWithUser(identity);
+	if(success){
+		touchSession(identity.GetSteamID64());
+	}
+	return success;
 }
 
 //! Call this  when you're done talking to a user on a specific channel. Once all open channels to a user have been closed, the open session to the user will be closed, and any new data from this user will trigger a SteamP2PSessionRequest_t callback.
@@ -4480,7 +5684,9 @@ bool Steam::closeSessionWithUser(const String& identity_reference){
 	if(SteamNetworkingMessages() == NULL){
 		return false;
 	}
-	return SteamNetworkingMessages()->CloseSessionWithUser(networking_identities[identity_reference.utf8().get_data()]);
+	const SteamNetworkingIdentity &identity = networking_identities[identity_reference.utf8().get_data()];
+	managed_sessions.erase(identity.GetSteamID64());
+	return SteamNetworkingMessages()->CloseSessionWithUser(identity);
 }
 
 //! Returns information about the latest state of a connection, if any, with the given peer.
@@ -4532,6 +5738,9 @@ Dictionary Steam::getSessionConnectionInfo(const String& identity_reference, boo
 //! Reads the next message that has been sent from another user via SendMessageToUser() on the given channel. Returns number of messages returned into your list.  (0 if no message are available on that channel.)
 Array Steam::receiveMessagesOnChannel(int channel, int max_messages){
 	Array messages;
+	if(message_replay_file.is_open()){
+		return replayMessages(MESSAGE_LOG_API_MESSAGES, -1, -1, channel, max_messages);
+	}
 	if(SteamNetworkingMessages() != NULL){
 		// Allocate the space for the messages
 		SteamNetworkingMessage_t** channel_messages = new SteamNetworkingMessage_t*[max_messages];
@@ -4563,6 +5772,11 @@ Array Steam::receiveMessagesOnChannel(int channel, int max_messages){
 			message["flags"] = channel_messages[i]->m_nFlags;
 			message["user_data"] = (uint64_t)channel_messages[i]->m_nUserData;
 			messages.append(message);
+			// Record the message if capturing
+			if(message_capture_file.is_open()){
+				captureReceivedMessage(MESSAGE_LOG_API_MESSAGES, 0, channel_messages[i]);
+			}
+			touchSession(channel_messages[i]->m_identityPeer.GetSteamID64());
 			// Release the message
 			channel_messages[i]->Release();
 		}
@@ -4576,7 +5790,131 @@ int Steam::sendMessageToUser(const String& identity_reference, const PoolByteArr
 	if(SteamNetworkingMessages() == NULL){
 		return 0;
 	}
-	return SteamNetworkingMessages()->SendMessageToUser(networking_identities[identity_reference.utf8().get_data()], data.read().ptr(), data.size(), flags, channel);
+	const SteamNetworkingIdentity &identity = networking_identities[identity_reference.utf8().get_data()];
+	int result = SteamNetworkingMessages()->SendMessageToUser(identity, data.read().ptr(), data.size(), flags, channel);
+	if(result == k_EResultOK){
+		touchSession(identity.GetSteamID64());
+	}
+	// Record the message if capturing
+	if(message_capture_file.is_open() && result == k_EResultOK){
+		captureMessage(MESSAGE_LOG_DIRECTION_SENT, MESSAGE_LOG_API_MESSAGES, 0, 0, channel, flags, 0, 0, SteamNetworkingUtils()->GetLocalTimestamp(), &identity, data.read().ptr(), data.size());
+	}
+	return result;
+}
+
+// Allow sessions from this Steam ID when the allowlist accept policy is set.
+void Steam::addSessionAllowlist(uint64_t steam_id){
+	session_allowlist.insert(steam_id);
+}
+
+// Empty the session allowlist.
+void Steam::clearSessionAllowlist(){
+	session_allowlist.clear();
+}
+
+// Get every session the session manager is tracking and how long each has been idle, in seconds.
+Dictionary Steam::getManagedSessions(){
+	Dictionary sessions;
+	Array steam_ids;
+	PoolRealArray idle_time;
+	uint64_t now = (SteamNetworkingUtils() == NULL) ? 0 : SteamNetworkingUtils()->GetLocalTimestamp();
+	for(std::unordered_map<uint64_t, uint64_t>::const_iterator session = managed_sessions.begin(); session != managed_sessions.end(); ++session){
+		steam_ids.append(session->first);
+		idle_time.append((now > session->second) ? (now - session->second) / 1000000.0 : 0.0);
+	}
+	sessions["steam_ids"] = steam_ids;
+	sessions["idle_time"] = idle_time;
+	return sessions;
+}
+
+// Receive from several channels in one call; messages are returned channel by channel in the order given.
+Array Steam::receiveMessagesOnChannels(const PoolIntArray channels, int max_messages){
+	Array messages;
+	PoolIntArray::Read channels_read = channels.read();
+	for(int i = 0; i < channels.size(); i++){
+		int remaining = max_messages - messages.size();
+		if(remaining <= 0){
+			break;
+		}
+		Array channel_messages = receiveMessagesOnChannel(channels_read[i], remaining);
+		for(int j = 0; j < channel_messages.size(); j++){
+			messages.append(channel_messages[j]);
+		}
+	}
+	return messages;
+}
+
+// Stop allowing sessions from this Steam ID.
+void Steam::removeSessionAllowlist(uint64_t steam_id){
+	session_allowlist.erase(steam_id);
+}
+
+// Set which session requests are accepted natively: any mix of SESSION_ACCEPT_FRIENDS, SESSION_ACCEPT_LOBBY and SESSION_ACCEPT_ALLOWLIST. Requests that do not match are still passed on through network_messages_session_request.
+void Steam::setSessionAcceptPolicy(int policy, uint64_t lobby_id){
+	session_accept_policy = policy;
+	session_accept_lobby = lobby_id;
+}
+
+// Close sessions that have not sent or received a message for this many seconds; 0 turns idle culling off.
+void Steam::setSessionIdleTimeout(float timeout){
+	session_idle_timeout = (uint64_t)(MAX(timeout, 0.0f) * 1000000.0f);
+}
+
+// Does the accept policy allow a session with this Steam ID?
+bool Steam::isSessionAllowed(uint64_t steam_id){
+	if(steam_id == 0){
+		return false;
+	}
+	if((session_accept_policy & SESSION_ACCEPT_ALLOWLIST) && session_allowlist.find(steam_id) != session_allowlist.end()){
+		return true;
+	}
+	CSteamID remote_id = (uint64)steam_id;
+	if((session_accept_policy & SESSION_ACCEPT_FRIENDS) && SteamFriends() != NULL && SteamFriends()->HasFriend(remote_id, k_EFriendFlagImmediate)){
+		return true;
+	}
+	if((session_accept_policy & SESSION_ACCEPT_LOBBY) && session_accept_lobby != 0 && SteamMatchmaking() != NULL){
+		CSteamID lobby_id = (uint64)session_accept_lobby;
+		int members = SteamMatchmaking()->GetNumLobbyMembers(lobby_id);
+		for(int i = 0; i < members; i++){
+			if(SteamMatchmaking()->GetLobbyMemberByIndex(lobby_id, i) == remote_id){
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Note activity on a session so it is not culled as idle.
+void Steam::touchSession(uint64_t steam_id){
+	if(steam_id != 0 && SteamNetworkingUtils() != NULL){
+		managed_sessions[steam_id] = SteamNetworkingUtils()->GetLocalTimestamp();
+	}
+}
+
+// Close idle sessions, checked once a second; called from run_callbacks while an idle timeout is set.
+void Steam::updateSessions(){
+	if(SteamNetworkingMessages() == NULL || SteamNetworkingUtils() == NULL){
+		return;
+	}
+	uint64_t now = SteamNetworkingUtils()->GetLocalTimestamp();
+	if(now < session_next_check){
+		return;
+	}
+	session_next_check = now + SESSION_CHECK_INTERVAL;
+	for(std::unordered_map<uint64_t, uint64_t>::iterator session = managed_sessions.begin(); session != managed_sessions.end();){
+		uint64_t idle = now - session->second;
+		if(session->second < now && idle > session_idle_timeout){
+			uint64_t steam_id = session->first;
+			SteamNetworkingIdentity remote;
+			remote.SetSteamID64(steam_id);
+			SteamNetworkingMessages()->CloseSessionWithUser(remote);
+			session = managed_sessions.erase(session);
+			emit_signal("network_messages_session_culled", steam_id, idle / 1000000.0);
+		}
+		else{
+			++session;
+		}
+	}
 }
 
 
@@ -4638,6 +5976,8 @@ bool Steam::closeConnection(uint32 peer, int reason, const String& debug_message
 	if(SteamNetworkingSockets() == NULL){
 		return false;
 	}
+	tracked_connections.erase(peer);
+	untracked_poll_groups.erase(peer);
 	return SteamNetworkingSockets()->CloseConnection((HSteamNetConnection)peer, reason, debug_message.utf8().get_data(), linger);
 }
 
@@ -4675,6 +6015,10 @@ Dictionary Steam::sendMessageToConnection(uint32 connection_handle, const PoolBy
 	if(SteamNetworkingSockets() != NULL){
 		int64 number;
 		int result = SteamNetworkingSockets()->SendMessageToConnection((HSteamNetConnection)connection_handle, data.read().ptr(), data.size(), flags, &number);
+		// Record the message if capturing
+		if(message_capture_file.is_open() && result == k_EResultOK){
+			captureMessage(MESSAGE_LOG_DIRECTION_SENT, MESSAGE_LOG_API_SOCKETS, connection_handle, 0, 0, flags, number, 0, SteamNetworkingUtils()->GetLocalTimestamp(), NULL, data.read().ptr(), data.size());
+		}
 		// Populate the dictionary
 		message_response["result"] = result;
 		message_response["message_number"] = (uint64_t)number;
@@ -4693,6 +6037,10 @@ void Steam::sendMessages(int messages, const PoolByteArray data, uint32 connecti
 		networkMessage->m_nFlags = flags;
 		int64 result;
 		SteamNetworkingSockets()->SendMessages(messages, &networkMessage, &result);
+		// Record the message if capturing
+		if(message_capture_file.is_open() && result > 0){
+			captureMessage(MESSAGE_LOG_DIRECTION_SENT, MESSAGE_LOG_API_SOCKETS, connection_handle, 0, 0, flags, result, 0, SteamNetworkingUtils()->GetLocalTimestamp(), NULL, data.read().ptr(), data.size());
+		}
 		// Release the message
 		networkMessage->Release();
 	}
@@ -4709,6 +6057,9 @@ int Steam::flushMessagesOnConnection(uint32 connection_handle){
 //! Fetch the next available message(s) from the connection, if any. Returns the number of messages returned into your array, up to nMaxMessages. If the connection handle is invalid, -1 is returned. If no data is available, 0, is returned.
 Array Steam::receiveMessagesOnConnection(uint32 connection_handle, int max_messages){
 	Array messages;
+	if(message_replay_file.is_open()){
+		return replayMessages(MESSAGE_LOG_API_SOCKETS, connection_handle, -1, -1, max_messages);
+	}
 	if(SteamNetworkingSockets() != NULL){
 		// Allocate the space for the messages
 		SteamNetworkingMessage_t** connection_messages = new SteamNetworkingMessage_t*[max_messages];
@@ -4740,6 +6091,10 @@ Array Steam::receiveMessagesOnConnection(uint32 connection_handle, int max_messa
 			message["flags"] = connection_messages[i]->m_nFlags;
 			message["user_data"] = (uint64_t)connection_messages[i]->m_nUserData;
 			messages.append(message);
+			// Record the message if capturing
+			if(message_capture_file.is_open()){
+				captureReceivedMessage(MESSAGE_LOG_API_SOCKETS, 0, connection_messages[i]);
+			}
 			// Release the message
 			connection_messages[i]->Release();
 		}
@@ -4761,7 +6116,23 @@ bool Steam::destroyPollGroup(uint32 poll_group){
 	if(SteamNetworkingSockets() == NULL){
 		return false;
 	}
-	return SteamNetworkingSockets()->DestroyPollGroup((HSteamNetPollGroup)poll_group);
+	bool success = SteamNetworkingSockets()->DestroyPollGroup((HSteamNetPollGroup)poll_group);
+	if(success){
+		for(std::unordered_map<uint32, TrackedConnection>::iterator tracked = tracked_connections.begin(); tracked != tracked_connections.end(); ++tracked){
+			if(tracked->second.poll_group == poll_group){
+				tracked->second.poll_group = 0;
+			}
+		}
+		for(std::unordered_map<uint32, uint32>::iterator untracked = untracked_poll_groups.begin(); untracked != untracked_poll_groups.end();){
+			if(untracked->second == poll_group){
+				untracked = untracked_poll_groups.erase(untracked);
+			}
+			else{
+				++untracked;
+			}
+		}
+	}
+	return success;
 }
 
 //! Assign a connection to a poll group. Note that a connection may only belong to a single poll group. Adding a connection to a poll group implicitly removes it from any other poll group it is in.
@@ -4769,12 +6140,26 @@ bool Steam::setConnectionPollGroup(uint32 connection_handle, uint32 poll_group){
 	if(SteamNetworkingSockets() == NULL){
 		return false;
 	}
-	return SteamNetworkingSockets()->SetConnectionPollGroup((HSteamNetConnection)connection_handle, (HSteamNetPollGroup)poll_group);
+	bool success = SteamNetworkingSockets()->SetConnectionPollGroup((HSteamNetConnection)connection_handle, (HSteamNetPollGroup)poll_group);
+	if(success){
+		std::unordered_map<uint32, TrackedConnection>::iterator tracked = tracked_connections.find(connection_handle);
+		if(tracked != tracked_connections.end()){
+			tracked->second.poll_group = poll_group;
+		}
+		// No status callback yet, so hand the poll group to the first one
+		else{
+			untracked_poll_groups[connection_handle] = poll_group;
+		}
+	}
+	return success;
 }
 
 //! Same as ReceiveMessagesOnConnection, but will return the next messages available on any connection in the poll group. Examine SteamNetworkingMessage_t::m_conn to know which connection. (SteamNetworkingMessage_t::m_nConnUserData might also be useful.)
 Array Steam::receiveMessagesOnPollGroup(uint32 poll_group, int max_messages){
 	Array messages;
+	if(message_replay_file.is_open()){
+		return replayMessages(MESSAGE_LOG_API_SOCKETS, -1, poll_group, -1, max_messages);
+	}
 	if(SteamNetworkingSockets() != NULL){
 		// Allocate the space for the messages
 		SteamNetworkingMessage_t** poll_messages = new SteamNetworkingMessage_t*[max_messages];
@@ -4806,6 +6191,10 @@ Array Steam::receiveMessagesOnPollGroup(uint32 poll_group, int max_messages){
 			message["flags"] = poll_messages[i]->m_nFlags;
 			message["user_data"] = (uint64_t)poll_messages[i]->m_nUserData;
 			messages.append(message);
+			// Record the message if capturing
+			if(message_capture_file.is_open()){
+				captureReceivedMessage(MESSAGE_LOG_API_SOCKETS, poll_group, poll_messages[i]);
+			}
 			// Release the message
 			poll_messages[i]->Release();
 		}
@@ -5201,6 +6590,127 @@ void Steam::createFakeUDPPort(int fake_server_port_index){
 	}
 }
 
+//! Set connection user data. The data is returned in the following places: by getConnectionUserData, in the connection status callbacks and in the user_data field of received messages.
+bool Steam::setConnectionUserData(uint32 peer, uint64_t user_data){
+	if(SteamNetworkingSockets() == NULL){
+		return false;
+	}
+	bool success = SteamNetworkingSockets()->SetConnectionUserData((HSteamNetConnection)peer, (int64)user_data);
+	if(success){
+		std::unordered_map<uint32, TrackedConnection>::iterator tracked = tracked_connections.find(peer);
+		if(tracked != tracked_connections.end()){
+			tracked->second.user_data = user_data;
+		}
+	}
+	return success;
+}
+
+// Get every connection in the native connection table as packed arrays, one entry per connection at the same index.
+Dictionary Steam::getConnectionTable(){
+	Dictionary table;
+	int count = tracked_connections.size();
+	PoolIntArray connections;
+	PoolIntArray states;
+	PoolIntArray end_reasons;
+	PoolIntArray listen_sockets;
+	PoolIntArray poll_groups;
+	PoolStringArray identities;
+	Array steam_ids;
+	Array user_data;
+	connections.resize(count);
+	states.resize(count);
+	end_reasons.resize(count);
+	listen_sockets.resize(count);
+	poll_groups.resize(count);
+	identities.resize(count);
+	steam_ids.resize(count);
+	user_data.resize(count);
+	PoolIntArray::Write connections_write = connections.write();
+	PoolIntArray::Write states_write = states.write();
+	PoolIntArray::Write end_reasons_write = end_reasons.write();
+	PoolIntArray::Write listen_sockets_write = listen_sockets.write();
+	PoolIntArray::Write poll_groups_write = poll_groups.write();
+	PoolStringArray::Write identities_write = identities.write();
+	int i = 0;
+	for(std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.begin(); tracked != tracked_connections.end(); ++tracked, ++i){
+		connections_write[i] = tracked->first;
+		states_write[i] = tracked->second.state;
+		end_reasons_write[i] = tracked->second.end_reason;
+		listen_sockets_write[i] = tracked->second.listen_socket;
+		poll_groups_write[i] = tracked->second.poll_group;
+		identities_write[i] = tracked->second.identity;
+		steam_ids[i] = tracked->second.steam_id;
+		user_data[i] = tracked->second.user_data;
+	}
+	connections_write.release();
+	states_write.release();
+	end_reasons_write.release();
+	listen_sockets_write.release();
+	poll_groups_write.release();
+	identities_write.release();
+	table["connections"] = connections;
+	table["states"] = states;
+	table["end_reasons"] = end_reasons;
+	table["listen_sockets"] = listen_sockets;
+	table["poll_groups"] = poll_groups;
+	table["identities"] = identities;
+	table["steam_ids"] = steam_ids;
+	table["user_data"] = user_data;
+	return table;
+}
+
+// Get one connection from the native connection table. Returns an empty dictionary if the connection is not tracked.
+Dictionary Steam::getTrackedConnection(uint32 connection){
+	Dictionary tracked_connection;
+	std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.find(connection);
+	if(tracked != tracked_connections.end()){
+		tracked_connection["connection_state"] = tracked->second.state;
+		tracked_connection["end_reason"] = tracked->second.end_reason;
+		tracked_connection["listen_socket"] = tracked->second.listen_socket;
+		tracked_connection["poll_group"] = tracked->second.poll_group;
+		tracked_connection["identity"] = tracked->second.identity;
+		tracked_connection["steam_id"] = tracked->second.steam_id;
+		tracked_connection["user_data"] = tracked->second.user_data;
+	}
+	return tracked_connection;
+}
+
+// Get the remote identity of a tracked connection without asking Steam.
+String Steam::getTrackedConnectionIdentity(uint32 connection){
+	std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.find(connection);
+	if(tracked == tracked_connections.end()){
+		return "";
+	}
+	return tracked->second.identity;
+}
+
+// Get the poll group a tracked connection was assigned to with setConnectionPollGroup, or 0.
+uint32 Steam::getTrackedConnectionPollGroup(uint32 connection){
+	std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.find(connection);
+	if(tracked == tracked_connections.end()){
+		return 0;
+	}
+	return tracked->second.poll_group;
+}
+
+// Get the last known state of a tracked connection without asking Steam.
+Steam::NetworkingConnectionState Steam::getTrackedConnectionState(uint32 connection){
+	std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.find(connection);
+	if(tracked == tracked_connections.end()){
+		return CONNECTION_STATE_NONE;
+	}
+	return NetworkingConnectionState(tracked->second.state);
+}
+
+// Get the user data of a tracked connection without asking Steam.
+uint64_t Steam::getTrackedConnectionUserData(uint32 connection){
+	std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.find(connection);
+	if(tracked == tracked_connections.end()){
+		return 0;
+	}
+	return tracked->second.user_data;
+}
+
 
 /////////////////////////////////////////////////
 ///// NETWORKING TYPES
@@ -5711,40 +7221,736 @@ bool Steam::setGlobalConfigValueFloat(NetworkingConfigValue config, float value)
 	if(SteamNetworkingUtils() == NULL){
 		return false;
 	}
-	return SteamNetworkingUtils()->SetGlobalConfigValueFloat((ESteamNetworkingConfigValue)config, value);
+	return SteamNetworkingUtils()->SetGlobalConfigValueFloat((ESteamNetworkingConfigValue)config, value);
+}
+bool Steam::setGlobalConfigValueString(NetworkingConfigValue config, const String& value){
+	if(SteamNetworkingUtils() == NULL){
+		return false;
+	}
+	return SteamNetworkingUtils()->SetGlobalConfigValueString((ESteamNetworkingConfigValue)config, value.utf8().get_data());
+}
+bool Steam::setConnectionConfigValueInt32(uint32 connection, NetworkingConfigValue config, int32 value){
+	if(SteamNetworkingUtils() == NULL){
+		return false;
+	}
+	return SteamNetworkingUtils()->SetConnectionConfigValueInt32(connection, (ESteamNetworkingConfigValue)config, value);
+}
+bool Steam::setConnectionConfigValueFloat(uint32 connection, NetworkingConfigValue config, float value){
+	if(SteamNetworkingUtils() == NULL){
+		return false;
+	}
+	return SteamNetworkingUtils()->SetConnectionConfigValueFloat(connection, (ESteamNetworkingConfigValue)config, value);
+}
+
+bool Steam::setConnectionConfigValueString(uint32 connection, NetworkingConfigValue config, const String& value){
+	if(SteamNetworkingUtils() == NULL){
+		return false;
+	}
+	return SteamNetworkingUtils()->SetConnectionConfigValueString(connection, (ESteamNetworkingConfigValue)config, value.utf8().get_data());
+}
+
+//! A general purpose high resolution local timer with the following properties: Monotonicity is guaranteed. The initial value will be at least 24*3600*30*1e6, i.e. about 30 days worth of microseconds. In this way, the timestamp value of 0 will always be at least "30 days ago". Also, negative numbers will never be returned. Wraparound / overflow is not a practical concern.
+uint64_t Steam::getLocalTimestamp(){
+	if(SteamNetworkingUtils() == NULL){
+		return 0;
+	}
+	return SteamNetworkingUtils()->GetLocalTimestamp();
+}
+
+
+/////////////////////////////////////////////////
+///// NETWORKING CAPTURE
+/////////////////////////////////////////////////
+//
+// The message log is a fixed header, then 8-byte aligned records (record header, remote identity string, payload), then an index of record offsets written when the capture stops.
+struct MessageLogHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	uint64_t data_end;
+	uint64_t message_count;
+	uint64_t index_offset;
+	uint64_t reserved[3];
+};
+
+struct MessageLogRecord {
+	uint64_t time;
+	int64_t message_number;
+	uint64_t user_data;
+	uint32_t connection;
+	uint32_t poll_group;
+	int32_t channel;
+	int32_t flags;
+	uint32_t size;
+	uint8_t direction;
+	uint8_t api;
+	uint8_t identity_size;
+	uint8_t reserved;
+};
+
+// Start appending every message sent or received through the Networking Sockets and Networking Messages functions to a memory-mapped log.
+bool Steam::startMessageCapture(const String& path, uint32 initial_size){
+	if(message_capture_file.is_open()){
+		stopMessageCapture();
+	}
+	if(initial_size < MESSAGE_LOG_MIN_SIZE){
+		initial_size = MESSAGE_LOG_MIN_SIZE;
+	}
+	if(!message_capture_file.open(path, initial_size, true)){
+		printf("[Steam] Failed to open message capture log.\n");
+		return false;
+	}
+	MessageLogHeader *header = (MessageLogHeader*)message_capture_file.get_data();
+	memset(header, 0, sizeof(MessageLogHeader));
+	memcpy(header->magic, MESSAGE_LOG_MAGIC, sizeof(header->magic));
+	header->version = MESSAGE_LOG_VERSION;
+	header->header_size = sizeof(MessageLogHeader);
+	message_capture_end = sizeof(MessageLogHeader);
+	header->data_end = message_capture_end;
+	message_capture_index.clear();
+	return true;
+}
+
+// Write the index, trim the log to its used size and close it.
+Dictionary Steam::stopMessageCapture(){
+	Dictionary capture;
+	if(!message_capture_file.is_open()){
+		return capture;
+	}
+	// Index entries are stored in 8-byte units so each one fits in 32 bits
+	uint64_t index_size = message_capture_index.size() * sizeof(uint32_t);
+	uint64_t final_size = message_capture_end + index_size;
+	if(final_size > message_capture_file.get_size() && !message_capture_file.resize(final_size)){
+		printf("[Steam] Failed to write message capture index, replay will rebuild it.\n");
+		final_size = message_capture_end;
+	}
+	if(message_capture_file.is_open()){
+		uint8_t *data = message_capture_file.get_data();
+		if(index_size > 0){
+			memcpy(data + message_capture_end, &message_capture_index[0], index_size);
+		}
+		MessageLogHeader *header = (MessageLogHeader*)data;
+		header->index_offset = message_capture_end;
+		message_capture_file.flush();
+	}
+	capture["messages"] = (uint64_t)message_capture_index.size();
+	capture["size"] = final_size;
+	message_capture_file.close(final_size);
+	message_capture_index.clear();
+	message_capture_end = 0;
+	return capture;
+}
+
+// Is a message capture currently running.
+bool Steam::isCapturingMessages(){
+	return message_capture_file.is_open();
+}
+
+// Feed the received messages of a captured log back through receiveMessagesOnConnection, receiveMessagesOnPollGroup and receiveMessagesOnChannel instead of Steam. A speed of 2.0 replays twice as fast, 0 delivers everything immediately.
+bool Steam::startMessageReplay(const String& path, float speed){
+	stopMessageReplay();
+	if(!message_replay_file.open(path, 0, false)){
+		printf("[Steam] Failed to open message replay log.\n");
+		return false;
+	}
+	const uint8_t *data = message_replay_file.get_data();
+	uint64_t file_size = message_replay_file.get_size();
+	const MessageLogHeader *header = (const MessageLogHeader*)data;
+	if(file_size < sizeof(MessageLogHeader) || memcmp(header->magic, MESSAGE_LOG_MAGIC, sizeof(header->magic)) != 0 || header->version != MESSAGE_LOG_VERSION || header->data_end > file_size){
+		printf("[Steam] Message replay log is not valid.\n");
+		message_replay_file.close();
+		return false;
+	}
+	// Use the index if the capture was stopped cleanly, otherwise walk the records up to the last one written
+	// Divide rather than multiply so a corrupt message count cannot overflow the bounds check
+	if(header->index_offset != 0 && header->index_offset <= file_size && header->message_count <= (file_size - header->index_offset) / sizeof(uint32_t)){
+		const uint32_t *index = (const uint32_t*)(data + header->index_offset);
+		for(uint64_t i = 0; i < header->message_count; i++){
+			uint64_t offset = (uint64_t)index[i] << 3;
+			if(offset < header->header_size || offset + sizeof(MessageLogRecord) > header->data_end){
+				break;
+			}
+			const MessageLogRecord *record = (const MessageLogRecord*)(data + offset);
+			if(offset + MESSAGE_LOG_ALIGN(sizeof(MessageLogRecord) + record->identity_size + record->size) > header->data_end){
+				break;
+			}
+			if(record->direction == MESSAGE_LOG_DIRECTION_RECEIVED){
+				message_replay_offsets.push_back(offset);
+			}
+		}
+	}
+	else{
+		uint64_t offset = header->header_size;
+		while(offset + sizeof(MessageLogRecord) <= header->data_end){
+			const MessageLogRecord *record = (const MessageLogRecord*)(data + offset);
+			uint64_t record_size = MESSAGE_LOG_ALIGN(sizeof(MessageLogRecord) + record->identity_size + record->size);
+			if(offset + record_size > header->data_end){
+				break;
+			}
+			if(record->direction == MESSAGE_LOG_DIRECTION_RECEIVED){
+				message_replay_offsets.push_back(offset);
+			}
+			offset += record_size;
+		}
+	}
+	if(!message_replay_offsets.empty()){
+		message_replay_first_time = ((const MessageLogRecord*)(data + message_replay_offsets[0]))->time;
+	}
+	message_replay_start = OS::get_singleton()->get_ticks_usec();
+	message_replay_speed = speed;
+	return true;
+}
+
+// Stop a replay and go back to receiving from Steam.
+void Steam::stopMessageReplay(){
+	message_replay_file.close();
+	message_replay_offsets.clear();
+	message_replay_pending.clear();
+	message_replay_cursor = 0;
+	message_replay_first_time = 0;
+	message_replay_delivered = 0;
+	message_replay_idle_since = 0;
+}
+
+// Is a message replay currently running.
+bool Steam::isReplayingMessages(){
+	return message_replay_file.is_open();
+}
+
+// Get how far the current replay has progressed.
+Dictionary Steam::getMessageReplayStatus(){
+	Dictionary status;
+	status["replaying"] = message_replay_file.is_open();
+	status["total"] = (uint64_t)message_replay_offsets.size();
+	status["delivered"] = message_replay_delivered;
+	status["pending"] = (uint64_t)(message_replay_offsets.size() - message_replay_delivered);
+	return status;
+}
+
+// Append one message to the capture log, growing the mapping when it is full.
+void Steam::captureMessage(uint8 direction, uint8 api, uint32 connection, uint32 poll_group, int channel, int flags, int64 message_number, uint64_t user_data, uint64_t time, const SteamNetworkingIdentity* identity, const void* payload, uint32 size){
+	char identity_string[STEAM_BUFFER_SIZE] = "";
+	if(identity != NULL){
+		identity->ToString(identity_string, STEAM_BUFFER_SIZE);
+	}
+	uint32 identity_size = (uint32)strlen(identity_string);
+	uint64_t record_size = MESSAGE_LOG_ALIGN(sizeof(MessageLogRecord) + identity_size + size);
+	if(message_capture_end + record_size > message_capture_file.get_size()){
+		uint64_t new_size = message_capture_file.get_size() * 2;
+		while(message_capture_end + record_size > new_size){
+			new_size *= 2;
+		}
+		if(!message_capture_file.resize(new_size)){
+			printf("[Steam] Failed to grow message capture log, capture stopped.\n");
+			message_capture_file.close(message_capture_end);
+			message_capture_index.clear();
+			message_capture_end = 0;
+			return;
+		}
+	}
+	uint8_t *data = message_capture_file.get_data();
+	MessageLogRecord *record = (MessageLogRecord*)(data + message_capture_end);
+	record->time = time;
+	record->message_number = message_number;
+	record->user_data = user_data;
+	record->connection = connection;
+	record->poll_group = poll_group;
+	record->channel = channel;
+	record->flags = flags;
+	record->size = size;
+	record->direction = direction;
+	record->api = api;
+	record->identity_size = (uint8_t)identity_size;
+	record->reserved = 0;
+	memcpy(data + message_capture_end + sizeof(MessageLogRecord), identity_string, identity_size);
+	if(size > 0){
+		memcpy(data + message_capture_end + sizeof(MessageLogRecord) + identity_size, payload, size);
+	}
+	message_capture_index.push_back((uint32_t)(message_capture_end >> 3));
+	message_capture_end += record_size;
+	// Keep the header current so a crashed capture can still be replayed
+	MessageLogHeader *header = (MessageLogHeader*)data;
+	header->data_end = message_capture_end;
+	header->message_count = message_capture_index.size();
+}
+
+// Append a message returned by one of the receive functions to the capture log.
+void Steam::captureReceivedMessage(uint8 api, uint32 poll_group, const SteamNetworkingMessage_t* message){
+	captureMessage(MESSAGE_LOG_DIRECTION_RECEIVED, api, message->m_conn, poll_group, message->m_nChannel, message->m_nFlags, message->m_nMessageNumber, message->m_nUserData, message->m_usecTimeReceived, &message->m_identityPeer, message->m_pData, message->m_cbSize);
+}
+
+// Hand out replayed messages that are due, in capture order, for one of the receive functions. Connection, poll group or channel of -1 matches any.
+Array Steam::replayMessages(uint8 api, int64_t connection, int64_t poll_group, int channel, int max_messages){
+	Array messages;
+	const uint8_t *data = message_replay_file.get_data();
+	// Move every record that is due at the replay speed into the pending queue
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - message_replay_start;
+	while(message_replay_cursor < message_replay_offsets.size()){
+		const MessageLogRecord *record = (const MessageLogRecord*)(data + message_replay_offsets[message_replay_cursor]);
+		int64_t record_time = (int64_t)(record->time - message_replay_first_time);
+		if(message_replay_speed > 0 && record_time > 0 && (double)record_time > (double)elapsed * message_replay_speed){
+			break;
+		}
+		message_replay_pending.push_back(message_replay_offsets[message_replay_cursor]);
+		message_replay_cursor++;
+	}
+	// Deliver matching messages and keep the rest, in order, for other receive calls
+	size_t kept = 0;
+	for(size_t i = 0; i < message_replay_pending.size(); i++){
+		uint64_t offset = message_replay_pending[i];
+		const MessageLogRecord *record = (const MessageLogRecord*)(data + offset);
+		bool matches = messages.size() < max_messages && record->api == api && (connection < 0 || record->connection == (uint32_t)connection) && (poll_group < 0 || record->poll_group == (uint32_t)poll_group) && (channel < 0 || record->channel == channel);
+		if(!matches){
+			message_replay_pending[kept++] = offset;
+			continue;
+		}
+		const uint8_t *identity = data + offset + sizeof(MessageLogRecord);
+		PoolByteArray payload;
+		payload.resize(record->size);
+		if(record->size > 0){
+			memcpy(payload.write().ptr(), identity + record->identity_size, record->size);
+		}
+		Dictionary message;
+		message["payload"] = payload;
+		message["size"] = record->size;
+		message["connection"] = record->connection;
+		message["identity"] = String::utf8((const char*)identity, record->identity_size);
+		message["user_data"] = record->user_data;
+		message["time_received"] = record->time;
+		message["message_number"] = record->message_number;
+		message["channel"] = record->channel;
+		message["flags"] = record->flags;
+		messages.append(message);
+	}
+	message_replay_pending.resize(kept);
+	message_replay_delivered += messages.size();
+	// Once every record is due, stop waiting on records nothing has polled for a while
+	bool drained = message_replay_pending.empty();
+	if(message_replay_cursor == message_replay_offsets.size() && !drained){
+		uint64_t now = OS::get_singleton()->get_ticks_usec();
+		if(messages.size() > 0 || message_replay_idle_since == 0){
+			message_replay_idle_since = now;
+		}
+		drained = now - message_replay_idle_since >= MESSAGE_REPLAY_DRAIN_TIMEOUT;
+	}
+	// Close the log once everything captured has been delivered
+	if(message_replay_cursor == message_replay_offsets.size() && drained){
+		uint64_t delivered = message_replay_delivered;
+		stopMessageReplay();
+		call_deferred("emit_signal", "message_replay_finished", delivered);
+	}
+	return messages;
+}
+
+
+/////////////////////////////////////////////////
+///// NETWORKING TIME SYNC
+/////////////////////////////////////////////////
+//
+// Time sync packets are sent unreliably on their own Networking Messages channel; all timestamps are Steam local timestamps in microseconds.
+// Start the time sync service. Every peer running it answers pings on the channel; peers given a host Steam ID also ping that host and track its clock. Pass 0 to act as the time host.
+bool Steam::startTimeSync(uint64_t host_steam_id, int channel, float interval){
+	if(SteamNetworkingMessages() == NULL || SteamNetworkingUtils() == NULL){
+		return false;
+	}
+	time_sync_active = true;
+	time_sync_host = host_steam_id;
+	time_sync_channel = channel;
+	time_sync_interval = (uint64_t)(MAX(interval, 0.05f) * 1000000.0f);
+	time_sync_next_ping = 0;
+	time_sync_sequence = 0;
+	time_sync_samples.clear();
+	time_sync_offset = 0.0;
+	time_sync_drift = 0.0;
+	time_sync_reference = SteamNetworkingUtils()->GetLocalTimestamp();
+	time_sync_rtt = 0;
+	return true;
+}
+
+// Stop pinging and answering pings; the last estimate is kept so getServerTime keeps working.
+void Steam::stopTimeSync(){
+	time_sync_active = false;
+}
+
+// Get the shared server time in microseconds. On the time host, or before any sync, this is the local timestamp.
+uint64_t Steam::getServerTime(){
+	if(SteamNetworkingUtils() == NULL){
+		return 0;
+	}
+	int64_t local_time = (int64_t)SteamNetworkingUtils()->GetLocalTimestamp();
+	if(time_sync_host == 0){
+		return (uint64_t)local_time;
+	}
+	double elapsed = (double)(local_time - (int64_t)time_sync_reference);
+	return (uint64_t)(local_time + (int64_t)(time_sync_offset + time_sync_drift * elapsed));
+}
+
+// Get the current estimate: offset to the host clock in microseconds, drift in parts per million, round-trip time and sample count.
+Dictionary Steam::getTimeSyncStatus(){
+	Dictionary status;
+	status["active"] = time_sync_active;
+	status["host"] = time_sync_host;
+	status["channel"] = time_sync_channel;
+	status["synced"] = isTimeSynced();
+	status["offset"] = (int64_t)time_sync_offset;
+	status["drift"] = time_sync_drift * 1000000.0;
+	status["rtt"] = time_sync_rtt;
+	status["samples"] = (int)time_sync_samples.size();
+	return status;
+}
+
+// Is the server time estimate usable yet? Always true on the time host.
+bool Steam::isTimeSynced(){
+	if(time_sync_host == 0){
+		return time_sync_active;
+	}
+	return time_sync_samples.size() >= TIME_SYNC_MIN_SAMPLES;
+}
+
+// Answer pings, collect pongs and send the next ping; called from run_callbacks while the service is active.
+void Steam::updateTimeSync(){
+	if(SteamNetworkingMessages() == NULL || SteamNetworkingUtils() == NULL){
+		return;
+	}
+	bool updated = false;
+	SteamNetworkingMessage_t* sync_messages[TIME_SYNC_RECEIVE_MAX];
+	int available_messages = SteamNetworkingMessages()->ReceiveMessagesOnChannel(time_sync_channel, sync_messages, TIME_SYNC_RECEIVE_MAX);
+	for(int i = 0; i < available_messages; i++){
+		// Time sync traffic keeps the session from being culled as idle
+		touchSession(sync_messages[i]->m_identityPeer.GetSteamID64());
+		if(sync_messages[i]->m_cbSize == sizeof(TimeSyncPacket)){
+			TimeSyncPacket packet;
+			memcpy(&packet, sync_messages[i]->m_pData, sizeof(TimeSyncPacket));
+			if(packet.type == TIME_SYNC_PING){
+				packet.type = TIME_SYNC_PONG;
+				packet.server_receive = (uint64_t)sync_messages[i]->m_usecTimeReceived;
+				packet.server_send = SteamNetworkingUtils()->GetLocalTimestamp();
+				SteamNetworkingMessages()->SendMessageToUser(sync_messages[i]->m_identityPeer, &packet, sizeof(TimeSyncPacket), k_nSteamNetworkingSend_Unreliable | k_nSteamNetworkingSend_NoNagle, time_sync_channel);
+			}
+			else if(packet.type == TIME_SYNC_PONG && time_sync_host != 0 && sync_messages[i]->m_identityPeer.GetSteamID64() == time_sync_host){
+				addTimeSyncSample(packet, (uint64_t)sync_messages[i]->m_usecTimeReceived);
+				updated = true;
+			}
+		}
+		sync_messages[i]->Release();
+	}
+	if(updated){
+		emit_signal("time_sync_updated", (int64_t)time_sync_offset, time_sync_rtt);
+	}
+	// Ping the host at the configured interval
+	uint64_t now = SteamNetworkingUtils()->GetLocalTimestamp();
+	if(time_sync_host != 0 && now >= time_sync_next_ping){
+		TimeSyncPacket packet;
+		memset(&packet, 0, sizeof(TimeSyncPacket));
+		packet.type = TIME_SYNC_PING;
+		packet.sequence = ++time_sync_sequence;
+		packet.client_send = now;
+		SteamNetworkingIdentity host;
+		host.SetSteamID64(time_sync_host);
+		SteamNetworkingMessages()->SendMessageToUser(host, &packet, sizeof(TimeSyncPacket), k_nSteamNetworkingSend_Unreliable | k_nSteamNetworkingSend_NoNagle | k_nSteamNetworkingSend_AutoRestartBrokenSession, time_sync_channel);
+		touchSession(time_sync_host);
+		// Ping faster until there are enough samples for an estimate
+		time_sync_next_ping = now + (isTimeSynced() ? time_sync_interval : time_sync_interval / 4);
+	}
+}
+
+// Add one ping / pong exchange and re-estimate offset and drift from the samples whose round trip was no slower than the median.
+void Steam::addTimeSyncSample(const TimeSyncPacket& packet, uint64_t client_receive){
+	int64_t round_trip = ((int64_t)client_receive - (int64_t)packet.client_send) - ((int64_t)packet.server_send - (int64_t)packet.server_receive);
+	if(round_trip < 0 || packet.client_send == 0){
+		return;
+	}
+	TimeSyncSample sample;
+	sample.local_time = client_receive;
+	sample.offset = (((int64_t)packet.server_receive - (int64_t)packet.client_send) + ((int64_t)packet.server_send - (int64_t)client_receive)) / 2;
+	sample.rtt = round_trip;
+	time_sync_samples.push_back(sample);
+	if(time_sync_samples.size() > TIME_SYNC_SAMPLES){
+		time_sync_samples.erase(time_sync_samples.begin());
+	}
+	// Reject samples delayed by queuing; their offset error is up to half their round trip
+	std::vector<int64_t> round_trips;
+	for(size_t i = 0; i < time_sync_samples.size(); i++){
+		round_trips.push_back(time_sync_samples[i].rtt);
+	}
+	std::sort(round_trips.begin(), round_trips.end());
+	int64_t median_rtt = round_trips[round_trips.size() / 2];
+	time_sync_rtt = round_trips[0];
+	std::vector<const TimeSyncSample*> accepted;
+	for(size_t i = 0; i < time_sync_samples.size(); i++){
+		if(time_sync_samples[i].rtt <= median_rtt){
+			accepted.push_back(&time_sync_samples[i]);
+		}
+	}
+	// Fit offset against local time; the slope is the drift between the two clocks
+	double mean_time = 0.0;
+	double mean_offset = 0.0;
+	for(size_t i = 0; i < accepted.size(); i++){
+		mean_time += (double)(accepted[i]->local_time - accepted[0]->local_time);
+		mean_offset += (double)accepted[i]->offset;
+	}
+	mean_time /= accepted.size();
+	mean_offset /= accepted.size();
+	double covariance = 0.0;
+	double variance = 0.0;
+	for(size_t i = 0; i < accepted.size(); i++){
+		double time_delta = (double)(accepted[i]->local_time - accepted[0]->local_time) - mean_time;
+		covariance += time_delta * ((double)accepted[i]->offset - mean_offset);
+		variance += time_delta * time_delta;
+	}
+	time_sync_drift = 0.0;
+	if(accepted.size() >= TIME_SYNC_MIN_SAMPLES && variance > 0.0){
+		time_sync_drift = CLAMP(covariance / variance, -TIME_SYNC_MAX_DRIFT, TIME_SYNC_MAX_DRIFT);
+	}
+	time_sync_reference = accepted[0]->local_time + (uint64_t)mean_time;
+	time_sync_offset = mean_offset;
 }
-bool Steam::setGlobalConfigValueString(NetworkingConfigValue config, const String& value){
-	if(SteamNetworkingUtils() == NULL){
+
+
+/////////////////////////////////////////////////
+///// NETWORKING TELEMETRY
+/////////////////////////////////////////////////
+//
+// Start sampling the real-time status of every connected Networking Sockets connection at a fixed interval, keeping the last history_size samples per connection.
+bool Steam::startConnectionTelemetry(float interval, uint32 history_size){
+	if(SteamNetworkingSockets() == NULL || SteamNetworkingUtils() == NULL){
 		return false;
 	}
-	return SteamNetworkingUtils()->SetGlobalConfigValueString((ESteamNetworkingConfigValue)config, value.utf8().get_data());
-}
-bool Steam::setConnectionConfigValueInt32(uint32 connection, NetworkingConfigValue config, int32 value){
-	if(SteamNetworkingUtils() == NULL){
+	if(history_size == 0){
+		printf("[Steam] Connection telemetry needs a history size of at least one sample.\n");
 		return false;
 	}
-	return SteamNetworkingUtils()->SetConnectionConfigValueInt32(connection, (ESteamNetworkingConfigValue)config, value);
-}
-bool Steam::setConnectionConfigValueFloat(uint32 connection, NetworkingConfigValue config, float value){
-	if(SteamNetworkingUtils() == NULL){
-		return false;
+	telemetry_active = true;
+	telemetry_interval = (uint64_t)(MAX(interval, 0.01f) * 1000000.0f);
+	telemetry_next_sample = 0;
+	if(telemetry_history_size != history_size){
+		telemetry_history_size = history_size;
+		connection_telemetry.clear();
+	}
+	return true;
+}
+
+// Stop sampling; recorded history stays queryable until clearConnectionTelemetry is called.
+void Steam::stopConnectionTelemetry(){
+	telemetry_active = false;
+}
+
+// Throw away all recorded history.
+void Steam::clearConnectionTelemetry(){
+	connection_telemetry.clear();
+}
+
+// Get the recorded samples of one connection, oldest first, as packed arrays.
+Dictionary Steam::getConnectionTelemetry(uint32 connection){
+	Dictionary telemetry;
+	std::unordered_map<uint32, ConnectionTelemetry>::const_iterator found = connection_telemetry.find(connection);
+	if(found == connection_telemetry.end()){
+		return telemetry;
+	}
+	const ConnectionTelemetry &history = found->second;
+	PoolIntArray time;
+	PoolIntArray ping;
+	PoolRealArray local_quality;
+	PoolRealArray remote_quality;
+	PoolRealArray bytes_in_per_second;
+	PoolRealArray bytes_out_per_second;
+	PoolIntArray pending;
+	PoolIntArray queue_time;
+	time.resize(history.count);
+	ping.resize(history.count);
+	local_quality.resize(history.count);
+	remote_quality.resize(history.count);
+	bytes_in_per_second.resize(history.count);
+	bytes_out_per_second.resize(history.count);
+	pending.resize(history.count);
+	queue_time.resize(history.count);
+	PoolIntArray::Write time_write = time.write();
+	PoolIntArray::Write ping_write = ping.write();
+	PoolRealArray::Write local_quality_write = local_quality.write();
+	PoolRealArray::Write remote_quality_write = remote_quality.write();
+	PoolRealArray::Write bytes_in_write = bytes_in_per_second.write();
+	PoolRealArray::Write bytes_out_write = bytes_out_per_second.write();
+	PoolIntArray::Write pending_write = pending.write();
+	PoolIntArray::Write queue_time_write = queue_time.write();
+	// The oldest sample sits at head once the ring has wrapped
+	uint32 oldest = (history.count < telemetry_history_size) ? 0 : history.head;
+	for(uint32 i = 0; i < history.count; i++){
+		const TelemetrySample &sample = history.samples[(oldest + i) % telemetry_history_size];
+		// Times are milliseconds relative to the newest sample so they fit a 32-bit array
+		time_write[i] = (int)(((int64_t)sample.time - (int64_t)history.last_time) / 1000);
+		ping_write[i] = sample.ping;
+		local_quality_write[i] = sample.local_quality;
+		remote_quality_write[i] = sample.remote_quality;
+		bytes_in_write[i] = sample.bytes_in_per_second;
+		bytes_out_write[i] = sample.bytes_out_per_second;
+		pending_write[i] = sample.pending;
+		queue_time_write[i] = sample.queue_time;
+	}
+	time_write.release();
+	ping_write.release();
+	local_quality_write.release();
+	remote_quality_write.release();
+	bytes_in_write.release();
+	bytes_out_write.release();
+	pending_write.release();
+	queue_time_write.release();
+	telemetry["last_sample_time"] = history.last_time;
+	telemetry["time"] = time;
+	telemetry["ping"] = ping;
+	telemetry["local_quality"] = local_quality;
+	telemetry["remote_quality"] = remote_quality;
+	telemetry["bytes_in_per_second"] = bytes_in_per_second;
+	telemetry["bytes_out_per_second"] = bytes_out_per_second;
+	telemetry["pending"] = pending;
+	telemetry["queue_time"] = queue_time;
+	return telemetry;
+}
+
+// Get rolling ping (milliseconds) and queue time (microseconds) percentiles plus the latest sample for every sampled connection, one entry per connection at the same index.
+Dictionary Steam::getConnectionTelemetrySummary(){
+	Dictionary summary;
+	int count = connection_telemetry.size();
+	PoolIntArray connections;
+	PoolIntArray samples;
+	PoolIntArray ping_p50;
+	PoolIntArray ping_p95;
+	PoolIntArray ping_p99;
+	PoolIntArray queue_time_p50;
+	PoolIntArray queue_time_p95;
+	PoolIntArray queue_time_p99;
+	PoolRealArray local_quality;
+	PoolRealArray remote_quality;
+	PoolRealArray bytes_in_per_second;
+	PoolRealArray bytes_out_per_second;
+	PoolIntArray pending;
+	connections.resize(count);
+	samples.resize(count);
+	ping_p50.resize(count);
+	ping_p95.resize(count);
+	ping_p99.resize(count);
+	queue_time_p50.resize(count);
+	queue_time_p95.resize(count);
+	queue_time_p99.resize(count);
+	local_quality.resize(count);
+	remote_quality.resize(count);
+	bytes_in_per_second.resize(count);
+	bytes_out_per_second.resize(count);
+	pending.resize(count);
+	int i = 0;
+	for(std::unordered_map<uint32, ConnectionTelemetry>::const_iterator found = connection_telemetry.begin(); found != connection_telemetry.end(); ++found, ++i){
+		const ConnectionTelemetry &history = found->second;
+		const TelemetrySample &latest = history.samples[(history.head + telemetry_history_size - 1) % telemetry_history_size];
+		connections.set(i, found->first);
+		samples.set(i, history.count);
+		ping_p50.set(i, getTelemetryPercentile(history.ping_histogram, history.count, 0.50));
+		ping_p95.set(i, getTelemetryPercentile(history.ping_histogram, history.count, 0.95));
+		ping_p99.set(i, getTelemetryPercentile(history.ping_histogram, history.count, 0.99));
+		queue_time_p50.set(i, getTelemetryPercentile(history.queue_time_histogram, history.count, 0.50) * TELEMETRY_QUEUE_TIME_BUCKET);
+		queue_time_p95.set(i, getTelemetryPercentile(history.queue_time_histogram, history.count, 0.95) * TELEMETRY_QUEUE_TIME_BUCKET);
+		queue_time_p99.set(i, getTelemetryPercentile(history.queue_time_histogram, history.count, 0.99) * TELEMETRY_QUEUE_TIME_BUCKET);
+		local_quality.set(i, latest.local_quality);
+		remote_quality.set(i, latest.remote_quality);
+		bytes_in_per_second.set(i, latest.bytes_in_per_second);
+		bytes_out_per_second.set(i, latest.bytes_out_per_second);
+		pending.set(i, latest.pending);
+	}
+	summary["connections"] = connections;
+	summary["samples"] = samples;
+	summary["ping_p50"] = ping_p50;
+	summary["ping_p95"] = ping_p95;
+	summary["ping_p99"] = ping_p99;
+	summary["queue_time_p50"] = queue_time_p50;
+	summary["queue_time_p95"] = queue_time_p95;
+	summary["queue_time_p99"] = queue_time_p99;
+	summary["local_quality"] = local_quality;
+	summary["remote_quality"] = remote_quality;
+	summary["bytes_in_per_second"] = bytes_in_per_second;
+	summary["bytes_out_per_second"] = bytes_out_per_second;
+	summary["pending"] = pending;
+	return summary;
+}
+
+// Is connection telemetry currently sampling?
+bool Steam::isConnectionTelemetryActive(){
+	return telemetry_active;
+}
+
+// Sample every connected connection when the interval has passed; called from run_callbacks while telemetry is active.
+void Steam::updateConnectionTelemetry(){
+	if(SteamNetworkingSockets() == NULL || SteamNetworkingUtils() == NULL){
+		return;
+	}
+	uint64_t now = SteamNetworkingUtils()->GetLocalTimestamp();
+	if(now < telemetry_next_sample){
+		return;
+	}
+	telemetry_next_sample = now + telemetry_interval;
+	// Drop history of connections that no longer exist
+	for(std::unordered_map<uint32, ConnectionTelemetry>::iterator found = connection_telemetry.begin(); found != connection_telemetry.end();){
+		if(tracked_connections.find(found->first) == tracked_connections.end()){
+			found = connection_telemetry.erase(found);
+		}
+		else{
+			++found;
+		}
+	}
+	for(std::unordered_map<uint32, TrackedConnection>::const_iterator tracked = tracked_connections.begin(); tracked != tracked_connections.end(); ++tracked){
+		if(tracked->second.state != k_ESteamNetworkingConnectionState_Connected){
+			continue;
+		}
+		SteamNetConnectionRealTimeStatus_t status;
+		if(SteamNetworkingSockets()->GetConnectionRealTimeStatus((HSteamNetConnection)tracked->first, &status, 0, NULL) != k_EResultOK){
+			continue;
+		}
+		ConnectionTelemetry &history = connection_telemetry[tracked->first];
+		if(history.samples.empty()){
+			history.samples.resize(telemetry_history_size);
+			history.ping_histogram.resize(TELEMETRY_HISTOGRAM_BUCKETS, 0);
+			history.queue_time_histogram.resize(TELEMETRY_HISTOGRAM_BUCKETS, 0);
+		}
+		TelemetrySample &sample = history.samples[history.head];
+		// Remove the sample being overwritten from the rolling histograms
+		if(history.count == telemetry_history_size){
+			history.ping_histogram[getTelemetryBucket(sample.ping)]--;
+			history.queue_time_histogram[getTelemetryBucket(sample.queue_time / TELEMETRY_QUEUE_TIME_BUCKET)]--;
+		}
+		else{
+			history.count++;
+		}
+		sample.time = now;
+		sample.ping = status.m_nPing;
+		sample.local_quality = status.m_flConnectionQualityLocal;
+		sample.remote_quality = status.m_flConnectionQualityRemote;
+		sample.bytes_in_per_second = status.m_flInBytesPerSec;
+		sample.bytes_out_per_second = status.m_flOutBytesPerSec;
+		sample.pending = status.m_cbPendingUnreliable + status.m_cbPendingReliable;
+		sample.queue_time = (int)MIN(status.m_usecQueueTime, (SteamNetworkingMicroseconds)0x7FFFFFFF);
+		history.ping_histogram[getTelemetryBucket(sample.ping)]++;
+		history.queue_time_histogram[getTelemetryBucket(sample.queue_time / TELEMETRY_QUEUE_TIME_BUCKET)]++;
+		history.head = (history.head + 1) % telemetry_history_size;
+		history.last_time = now;
 	}
-	return SteamNetworkingUtils()->SetConnectionConfigValueFloat(connection, (ESteamNetworkingConfigValue)config, value);
 }
 
-bool Steam::setConnectionConfigValueString(uint32 connection, NetworkingConfigValue config, const String& value){
-	if(SteamNetworkingUtils() == NULL){
-		return false;
-	}
-	return SteamNetworkingUtils()->SetConnectionConfigValueString(connection, (ESteamNetworkingConfigValue)config, value.utf8().get_data());
+// Clamp a value into the histogram range.
+int Steam::getTelemetryBucket(int value){
+	return CLAMP(value, 0, TELEMETRY_HISTOGRAM_BUCKETS - 1);
 }
 
-//! A general purpose high resolution local timer with the following properties: Monotonicity is guaranteed. The initial value will be at least 24*3600*30*1e6, i.e. about 30 days worth of microseconds. In this way, the timestamp value of 0 will always be at least "30 days ago". Also, negative numbers will never be returned. Wraparound / overflow is not a practical concern.
-uint64_t Steam::getLocalTimestamp(){
-	if(SteamNetworkingUtils() == NULL){
+// Walk a histogram until the requested fraction of samples is covered.
+int Steam::getTelemetryPercentile(const std::vector<uint32_t>& histogram, uint32 count, float percentile){
+	if(count == 0){
 		return 0;
 	}
-	return SteamNetworkingUtils()->GetLocalTimestamp();
+	uint32 target = (uint32)ceilf(percentile * count);
+	uint32 covered = 0;
+	for(int i = 0; i < TELEMETRY_HISTOGRAM_BUCKETS; i++){
+		covered += histogram[i];
+		if(covered >= target){
+			return i;
+		}
+	}
+	return TELEMETRY_HISTOGRAM_BUCKETS - 1;
 }
 
 
@@ -5906,6 +8112,22 @@ Dictionary Steam::getBeaconDetails(uint64_t beacon_id){
 	return details;
 }
 
+//! Get every active beacon's ID, owner, location type, location ID and metadata as parallel arrays in one call. types and metadata are packed; beacon_ids, owner_ids and location_ids are plain arrays of ints since PoolIntArray only holds 32-bit values. The snapshot is then refreshed when active_beacons_updated arrives, so later calls cost no Steamworks calls; what changed arrives through beacons_snapshot_changed.
+Dictionary Steam::getBeaconsSnapshot(){
+	if(SteamParties() == NULL){
+		return Dictionary();
+	}
+	if(!beacons_snapshot_active){
+		readBeaconsSnapshot(beacons_snapshot, std::vector<BeaconSnapshotEntry>(), std::unordered_map<uint64_t, uint32_t>());
+		beacons_snapshot_active = true;
+	}
+	std::vector<uint32_t> indices(beacons_snapshot.size());
+	for(uint32_t i = 0; i < indices.size(); i++){
+		indices[i] = i;
+	}
+	return packBeaconsSnapshot(indices);
+}
+
 //! When the user indicates they wish to join the party advertised by a given beacon, call this method. On success, Steam will reserve a slot for this user in the party and return the necessary "join game" string to use to complete the connection.
 void Steam::joinParty(uint64_t beacon_id){
 	if(SteamParties() != NULL){
@@ -5932,6 +8154,68 @@ String Steam::getBeaconLocationData(uint64_t location_id, SteamPartyBeaconLocati
 	return beacon_location_data;
 }
 
+// Read every active beacon and its details. A beacon whose details cannot be read keeps its entry from the previous snapshot, if it had one.
+void Steam::readBeaconsSnapshot(std::vector<BeaconSnapshotEntry>& beacons, const std::vector<BeaconSnapshotEntry>& previous, const std::unordered_map<uint64_t, uint32_t>& previous_index){
+	beacons.clear();
+	uint32 count = SteamParties()->GetNumActiveBeacons();
+	beacons.reserve(count);
+	char metadata[STEAM_LARGE_BUFFER_SIZE];
+	for(uint32 i = 0; i < count; i++){
+		BeaconSnapshotEntry entry;
+		entry.beacon_id = SteamParties()->GetBeaconByIndex(i);
+		CSteamID owner;
+		SteamPartyBeaconLocation_t location;
+		if(entry.beacon_id == 0){
+			continue;
+		}
+		if(!SteamParties()->GetBeaconDetails(entry.beacon_id, &owner, &location, metadata, STEAM_LARGE_BUFFER_SIZE)){
+			std::unordered_map<uint64_t, uint32_t>::const_iterator found = previous_index.find(entry.beacon_id);
+			if(found != previous_index.end()){
+				beacons.push_back(previous[found->second]);
+			}
+			continue;
+		}
+		entry.owner_id = owner.ConvertToUint64();
+		entry.type = location.m_eType;
+		entry.location_id = location.m_ulLocationID;
+		entry.metadata = String::utf8(metadata);
+		beacons.push_back(entry);
+	}
+}
+
+// Pack the given snapshot entries into parallel arrays.
+Dictionary Steam::packBeaconsSnapshot(const std::vector<uint32_t>& indices){
+	Array beacon_ids;
+	Array owner_ids;
+	PoolIntArray types;
+	Array location_ids;
+	PoolStringArray metadata;
+	beacon_ids.resize(indices.size());
+	owner_ids.resize(indices.size());
+	types.resize(indices.size());
+	location_ids.resize(indices.size());
+	metadata.resize(indices.size());
+	{
+		PoolIntArray::Write types_write = types.write();
+		PoolStringArray::Write metadata_write = metadata.write();
+		for(uint32_t i = 0; i < indices.size(); i++){
+			const BeaconSnapshotEntry &entry = beacons_snapshot[indices[i]];
+			beacon_ids[i] = (uint64_t)entry.beacon_id;
+			owner_ids[i] = (uint64_t)entry.owner_id;
+			types_write[i] = entry.type;
+			location_ids[i] = (uint64_t)entry.location_id;
+			metadata_write[i] = entry.metadata;
+		}
+	}
+	Dictionary snapshot;
+	snapshot["beacon_ids"] = beacon_ids;
+	snapshot["owner_ids"] = owner_ids;
+	snapshot["types"] = types;
+	snapshot["location_ids"] = location_ids;
+	snapshot["metadata"] = metadata;
+	return snapshot;
+}
+
 
 /////////////////////////////////////////////////
 ///// REMOTE PLAY 
@@ -7738,6 +10022,7 @@ Dictionary Steam::decompressVoice(const PoolByteArray& voice, uint32 voice_size,
 	
 		int result = SteamUser()->DecompressVoice(voice.read().ptr(), voice_size, outputBuffer.write().ptr(), outputBuffer.size(), &written, sample_rate);
 		if(result == 0){
+			outputBuffer.resize(written);
 			decompressed["uncompressed"] = outputBuffer;
 			decompressed["size"] = written;
 		} 
@@ -8795,6 +11080,27 @@ bool Steam::overlayNeedsPresent(){
 	return SteamUtils()->BOverlayNeedsPresent();
 }
 
+//! Copy a Steam image and convert it to a texture on a worker thread, optionally with mipmaps. Returns a request ID; image_texture_loaded is emitted with it once the texture is ready.
+uint32 Steam::requestImageTexture(int image, bool mipmaps){
+	if(SteamUtils() == NULL || image <= 0){
+		return 0;
+	}
+	if(!image_thread.is_started()){
+		image_thread_exit = false;
+		image_thread.start(image_thread_function, this);
+	}
+	ImageRequest request;
+	request.id = ++image_request_id;
+	request.handle = image;
+	request.mipmaps = mipmaps;
+	image_mutex.lock();
+	image_requests.push_back(request);
+	image_mutex.unlock();
+	image_requests_outstanding++;
+	image_semaphore.post();
+	return request.id;
+}
+
 //! Sets the inset of the overlay notification from the corner specified by SetOverlayNotificationPosition.
 void Steam::setOverlayNotificationInset(int horizontal, int vertical){
 	if(SteamUtils() != NULL){
@@ -8871,6 +11177,75 @@ bool Steam::dismissFloatingGamepadTextInput(){
 	return SteamUtils()->DismissFloatingGamepadTextInput();
 }
 
+// Copy and convert requested images until told to exit; the only Steam calls made here are GetImageSize and GetImageRGBA.
+void Steam::image_thread_function(void* userdata){
+	Steam* steam = (Steam*)userdata;
+	while(true){
+		steam->image_semaphore.wait();
+		steam->image_mutex.lock();
+		if(steam->image_thread_exit){
+			steam->image_mutex.unlock();
+			return;
+		}
+		if(steam->image_requests.empty()){
+			steam->image_mutex.unlock();
+			continue;
+		}
+		ImageRequest request = steam->image_requests.front();
+		steam->image_requests.pop_front();
+		steam->image_mutex.unlock();
+		// Do the copy and conversion without holding the lock
+		uint32 width = 0;
+		uint32 height = 0;
+		if(SteamUtils() != NULL && SteamUtils()->GetImageSize(request.handle, &width, &height) && width > 0 && height > 0){
+			PoolByteArray data;
+			data.resize(width * height * 4);
+			if(SteamUtils()->GetImageRGBA(request.handle, data.write().ptr(), data.size())){
+				request.image.instance();
+				request.image->create(width, height, false, Image::FORMAT_RGBA8, data);
+				if(request.mipmaps){
+					request.image->generate_mipmaps();
+				}
+			}
+		}
+		steam->image_mutex.lock();
+		steam->image_results.push_back(request);
+		steam->image_mutex.unlock();
+	}
+}
+
+// Upload finished images and emit their signals; called from run_callbacks while requests are outstanding.
+void Steam::deliverImageTextures(){
+	std::vector<ImageRequest> finished;
+	image_mutex.lock();
+	finished.swap(image_results);
+	image_mutex.unlock();
+	for(size_t i = 0; i < finished.size(); i++){
+		image_requests_outstanding--;
+		Ref<ImageTexture> texture;
+		if(finished[i].image.is_valid()){
+			texture.instance();
+			texture->create_from_image(finished[i].image, Texture::FLAG_FILTER | (finished[i].mipmaps ? Texture::FLAG_MIPMAPS : 0));
+		}
+		else{
+			printf("[Steam] Failed to load image %d.\n", finished[i].handle);
+		}
+		emit_signal("image_texture_loaded", finished[i].id, finished[i].handle, texture);
+	}
+}
+
+// Tell the image worker to finish and wait for it.
+void Steam::stopImageThread(){
+	if(!image_thread.is_started()){
+		return;
+	}
+	image_mutex.lock();
+	image_thread_exit = true;
+	image_mutex.unlock();
+	image_semaphore.post();
+	image_thread.wait_to_finish();
+}
+
 
 /////////////////////////////////////////////////
 ///// VIDEO
@@ -8918,6 +11293,206 @@ Dictionary Steam::isBroadcasting(){
 }
 
 
+/////////////////////////////////////////////////
+///// VOICE
+/////////////////////////////////////////////////
+//
+// Voice packets are a 4-byte sequence number followed by the compressed voice from GetVoice.
+//
+// Send captured voice to this user.
+void Steam::addVoicePeer(uint64_t steam_id){
+	voice_peers.insert(steam_id);
+}
+
+// Stop sending voice to every user.
+void Steam::clearVoicePeers(){
+	voice_peers.clear();
+}
+
+// Get the sample rate received voice is decompressed at; generators given to setVoicePlayback should use this mix rate.
+uint32 Steam::getVoicePipelineSampleRate(){
+	return voice_sample_rate;
+}
+
+// Is the voice pipeline running?
+bool Steam::isVoicePipelineActive(){
+	return voice_active;
+}
+
+// Stop sending voice to this user.
+void Steam::removeVoicePeer(uint64_t steam_id){
+	voice_peers.erase(steam_id);
+}
+
+// Push this user's received voice into the given generator playback; pass null to send it through the jitter buffer and SteamVoiceStream instead.
+void Steam::setVoicePlayback(uint64_t steam_id, const Ref<AudioStreamGeneratorPlayback>& playback){
+	voice_speakers[steam_id].playback = playback;
+}
+
+// Set the range, in seconds, the adaptive playout delay of each speaker's jitter buffer may move in.
+void Steam::setVoiceJitterBuffer(float min_delay, float max_delay){
+	voice_min_delay = min_delay;
+	voice_max_delay = max_delay;
+	voice_mixer.configure(voice_sample_rate, voice_min_delay, voice_max_delay);
+}
+
+// Get the jitter buffer state of a speaker: buffered and target delay, jitter estimate and loss counters.
+Dictionary Steam::getVoiceSpeakerStatus(uint64_t steam_id){
+	Dictionary status;
+	float depth = 0.0;
+	float target = 0.0;
+	float jitter = 0.0;
+	uint32_t lost = 0;
+	uint32_t concealed = 0;
+	uint32_t underruns = 0;
+	uint32_t dropped = 0;
+	if(voice_mixer.get_speaker_status(steam_id, depth, target, jitter, lost, concealed, underruns, dropped)){
+		status["depth"] = depth;
+		status["target_delay"] = target;
+		status["jitter"] = jitter;
+		status["lost_packets"] = lost;
+		status["concealed_samples"] = concealed;
+		status["underruns"] = underruns;
+		status["dropped_samples"] = dropped;
+	}
+	return status;
+}
+
+// Start recording, sending captured voice to every voice peer on its own Networking Messages channel and playing received voice. A sample rate of 0 uses the optimal rate of the Steam decoder.
+bool Steam::startVoicePipeline(int channel, uint32 sample_rate){
+	if(SteamUser() == NULL || SteamNetworkingMessages() == NULL){
+		return false;
+	}
+	voice_channel = channel;
+	voice_sample_rate = (sample_rate == 0) ? SteamUser()->GetVoiceOptimalSampleRate() : sample_rate;
+	voice_mixer.configure(voice_sample_rate, voice_min_delay, voice_max_delay);
+	voice_capture_buffer.resize(VOICE_CAPTURE_BUFFER_SIZE);
+	if(voice_decompress_buffer.size() < VOICE_DECOMPRESS_BUFFER_SIZE){
+		voice_decompress_buffer.resize(VOICE_DECOMPRESS_BUFFER_SIZE);
+	}
+	if(!voice_active){
+		SteamUser()->StartVoiceRecording();
+	}
+	voice_active = true;
+	return true;
+}
+
+// Stop recording and playing voice. The send sequence keeps counting across restarts so peers do not drop the next session's packets as late; every speaker resyncs on its next packet.
+void Steam::stopVoicePipeline(){
+	if(voice_active && SteamUser() != NULL){
+		SteamUser()->StopVoiceRecording();
+	}
+	voice_active = false;
+	voice_mixer.clear();
+	for(std::unordered_map<uint64_t, VoiceSpeaker>::iterator speaker = voice_speakers.begin(); speaker != voice_speakers.end(); ++speaker){
+		speaker->second.last_sequence = 0;
+	}
+}
+
+// Send newly captured voice and play received voice; called from run_callbacks while the pipeline is active.
+void Steam::updateVoice(){
+	if(SteamUser() == NULL || SteamNetworkingMessages() == NULL){
+		return;
+	}
+	// Capture and send
+	uint32 compressed = 0;
+	if(SteamUser()->GetAvailableVoice(&compressed) == k_EVoiceResultOK && compressed > 0){
+		uint32 written = 0;
+		if(SteamUser()->GetVoice(true, &voice_capture_buffer[sizeof(uint32_t)], VOICE_CAPTURE_BUFFER_SIZE - sizeof(uint32_t), &written, false, NULL, 0, NULL, 0) == k_EVoiceResultOK && written > 0){
+			uint32_t sequence = ++voice_sequence;
+			memcpy(&voice_capture_buffer[0], &sequence, sizeof(uint32_t));
+			for(std::unordered_set<uint64_t>::const_iterator peer = voice_peers.begin(); peer != voice_peers.end(); ++peer){
+				SteamNetworkingIdentity remote;
+				remote.SetSteamID64(*peer);
+				if(SteamNetworkingMessages()->SendMessageToUser(remote, &voice_capture_buffer[0], written + sizeof(uint32_t), k_nSteamNetworkingSend_Unreliable | k_nSteamNetworkingSend_NoNagle | k_nSteamNetworkingSend_AutoRestartBrokenSession, voice_channel) == k_EResultOK){
+					touchSession(*peer);
+				}
+			}
+		}
+	}
+	// Receive and play
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+	SteamNetworkingMessage_t* voice_messages[VOICE_RECEIVE_MAX];
+	int available_messages = SteamNetworkingMessages()->ReceiveMessagesOnChannel(voice_channel, voice_messages, VOICE_RECEIVE_MAX);
+	for(int i = 0; i < available_messages; i++){
+		uint64_t steam_id = voice_messages[i]->m_identityPeer.GetSteamID64();
+		touchSession(steam_id);
+		if(steam_id != 0 && voice_messages[i]->m_cbSize > (int)sizeof(uint32_t)){
+			VoiceSpeaker &speaker = voice_speakers[steam_id];
+			const uint8_t* packet = (const uint8_t*)voice_messages[i]->m_pData;
+			uint32_t sequence;
+			memcpy(&sequence, packet, sizeof(uint32_t));
+			// Unreliable packets can arrive late; drop anything older than what was already played. A far jump back or a pause in speech means the sender restarted, so start over from this packet.
+			int32_t gap = (int32_t)(sequence - speaker.last_sequence);
+			bool resync = speaker.last_sequence == 0 || gap <= -VOICE_SEQUENCE_RESYNC_GAP || now - speaker.last_heard >= VOICE_SEQUENCE_RESYNC_IDLE;
+			speaker.last_heard = now;
+			if(resync || gap > 0){
+				uint32 lost = resync ? 0 : gap - 1;
+				speaker.last_sequence = sequence;
+				uint32 pcm_size = decompressVoicePacket(packet + sizeof(uint32_t), voice_messages[i]->m_cbSize - sizeof(uint32_t));
+				if(pcm_size > 0){
+					// Speakers without a generator go through the jitter buffer for SteamVoiceStream
+					if(speaker.playback.is_valid()){
+						pushVoiceFrames(speaker.playback, (const int16_t*)&voice_decompress_buffer[0], pcm_size / sizeof(int16_t));
+					}
+					else{
+						voice_mixer.push(steam_id, (const int16_t*)&voice_decompress_buffer[0], pcm_size / sizeof(int16_t), (uint64_t)voice_messages[i]->m_usecTimeReceived, lost);
+					}
+				}
+			}
+		}
+		voice_messages[i]->Release();
+	}
+	if(now >= voice_next_expiry){
+		expireVoiceSpeakers(now);
+		voice_next_expiry = now + VOICE_SPEAKER_EXPIRY_INTERVAL;
+	}
+}
+
+// Forget speakers not heard for a while, so anyone sending on the voice channel cannot grow the speaker tables forever. Speakers with a generator from setVoicePlayback are kept.
+void Steam::expireVoiceSpeakers(uint64_t now){
+	for(std::unordered_map<uint64_t, VoiceSpeaker>::iterator speaker = voice_speakers.begin(); speaker != voice_speakers.end();){
+		if(!speaker->second.playback.is_valid() && now - speaker->second.last_heard >= VOICE_SPEAKER_IDLE_TIMEOUT){
+			voice_mixer.remove_speaker(speaker->first);
+			speaker = voice_speakers.erase(speaker);
+		}
+		else{
+			++speaker;
+		}
+	}
+}
+
+// Decompress into the reused PCM buffer, growing it if Steam says it is too small. Returns the bytes written.
+uint32 Steam::decompressVoicePacket(const uint8_t* voice, uint32 voice_size){
+	uint32 written = 0;
+	EVoiceResult result = SteamUser()->DecompressVoice(voice, voice_size, &voice_decompress_buffer[0], voice_decompress_buffer.size(), &written, voice_sample_rate);
+	if(result == k_EVoiceResultBufferTooSmall && written > voice_decompress_buffer.size()){
+		voice_decompress_buffer.resize(written);
+		result = SteamUser()->DecompressVoice(voice, voice_size, &voice_decompress_buffer[0], voice_decompress_buffer.size(), &written, voice_sample_rate);
+	}
+	if(result != k_EVoiceResultOK){
+		return 0;
+	}
+	return written;
+}
+
+// Convert 16-bit mono PCM to stereo frames and push as many as the playback has room for.
+void Steam::pushVoiceFrames(const Ref<AudioStreamGeneratorPlayback>& playback, const int16_t* samples, int count){
+	int frames = MIN(count, playback->get_frames_available());
+	if(frames <= 0){
+		return;
+	}
+	voice_frames.resize(frames);
+	PoolVector2Array::Write frames_write = voice_frames.write();
+	for(int i = 0; i < frames; i++){
+		float sample = samples[i] / 32768.0f;
+		frames_write[i] = Vector2(sample, sample);
+	}
+	frames_write.release();
+	playback->push_buffer(voice_frames);
+}
+
+
 /////////////////////////////////////////////////
 ///// SIGNALS / CALLBACKS
 /////////////////////////////////////////////////
@@ -8975,22 +11550,31 @@ void Steam::app_uninstalled(SteamAppUninstalled_t* call_data){
 //
 //! Called when a large avatar is loaded if you have tried requesting it when it was unavailable.
 void Steam::avatar_loaded(AvatarImageLoaded_t* avatarData){
-	uint32 width, height;
-	bool success = SteamUtils()->GetImageSize(avatarData->m_iImage, &width, &height);
-	if(!success){
-		printf("[Steam] Failed to get image size.\n");
+	CSteamID steam_id = avatarData->m_steamID;
+	uint64_t avatar_id = steam_id.ConvertToUint64();
+	uint32 width = avatarData->m_iWide;
+	int size = (width <= 32) ? AVATAR_SMALL : ((width <= 64) ? AVATAR_MEDIUM : AVATAR_LARGE);
+	std::pair<uint64_t, int> key(avatar_id, size);
+	bool wanted = avatar_cache_pending.count(key) > 0 || avatar_atlas_pending.count(key) > 0;
+	// Only build the byte array for avatar_loaded when something listens to it
+	List<Connection> connections;
+	get_signal_connection_list("avatar_loaded", &connections);
+	bool legacy = !connections.empty();
+	if(!wanted && !legacy){
 		return;
 	}
-	PoolByteArray data;
-	data.resize(width * height * 4);
-	success = SteamUtils()->GetImageRGBA(avatarData->m_iImage, data.write().ptr(), data.size());
-	if(!success){
-		printf("[Steam] Failed to load image buffer from callback\n");
+	// Read the RGBA once and share it between the legacy signal, the avatar cache and the atlas
+	Ref<Image> image = getAvatarImage(avatarData->m_iImage);
+	if(image.is_null()){
 		return;
 	}
-	CSteamID steam_id = avatarData->m_steamID;
-	uint64_t avatar_id = steam_id.ConvertToUint64();
-	call_deferred("emit_signal", "avatar_loaded", avatar_id, width, data);
+	if(legacy){
+		call_deferred("emit_signal", "avatar_loaded", avatar_id, image->get_width(), image->get_data());
+	}
+	// Fill the avatar cache if this avatar was requested through it
+	if(wanted){
+		resolvePendingAvatar(avatar_id, size, image);
+	}
 }
 
 //! Called when a large avatar is loaded if you have tried requesting it when it was unavailable.
@@ -9026,6 +11610,10 @@ void Steam::clan_activity_downloaded(DownloadClanActivityCountsResult_t* call_da
 void Steam::friend_rich_presence_update(FriendRichPresenceUpdate_t* call_data){
 	uint64_t steam_id = call_data->m_steamIDFriend.ConvertToUint64();
 	AppId_t app_id = call_data->m_nAppID;
+	if(SteamFriends() != NULL){
+		mirrorFriendRichPresence(steam_id);
+	}
+	trackFriendChange(steam_id, k_EPersonaChangeRichPresence);
 	emit_signal("friend_rich_presence_updated", steam_id, app_id);
 }
 
@@ -9117,6 +11705,26 @@ void Steam::join_clan_chat_complete(JoinClanChatRoomCompletionResult_t* call_dat
 void Steam::persona_state_change(PersonaStateChange_t* call_data){
 	uint64_t steam_id = call_data->m_ulSteamID;
 	int flags = call_data->m_nChangeFlags;
+	// A new avatar replaces any cached texture; fetch it again for anyone who was showing it
+	if(flags & k_EPersonaChangeAvatar){
+		for(int size = AVATAR_SMALL; size <= AVATAR_LARGE; size++){
+			std::pair<uint64_t, int> key(steam_id, size);
+			std::map<std::pair<uint64_t, int>, std::list<AvatarCacheEntry>::iterator>::iterator cached = avatar_cache_index.find(key);
+			if(cached != avatar_cache_index.end()){
+				avatar_cache.erase(cached->second);
+				avatar_cache_index.erase(cached);
+				avatar_cache_pending.insert(key);
+			}
+			// Atlas slots are kept and redrawn in place
+			if(avatar_atlas_slots.count(key) > 0){
+				avatar_atlas_pending.insert(key);
+			}
+		}
+	}
+	for(int size = AVATAR_SMALL; size <= AVATAR_LARGE; size++){
+		resolvePendingAvatar(steam_id, size);
+	}
+	trackFriendChange(steam_id, flags);
 	emit_signal("persona_state_change", steam_id, flags);
 }
 
@@ -9181,6 +11789,23 @@ void Steam::search_for_game_progress(SearchForGameProgressCallback_t* call_data)
 	search_progress["seconds_remaining_estimate"] = call_data->m_nSecondsRemainingEstimate;
 	search_progress["players_searching"] = call_data->m_cPlayersSearching;
 	emit_signal("search_for_game_progress", result, search_id, search_progress);
+	// Feed a running startGameSearch
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_PLAYER];
+	if(run.state == GAME_SEARCH_STATE_SEARCHING && isCurrentGameSearch(GAME_SEARCH_ROLE_PLAYER, search_id)){
+		run.search_id = search_id;
+		if(result != k_EResultOK){
+			retryGameSearch(GAME_SEARCH_ROLE_PLAYER, "result_" + itos(result));
+		}
+		else if(steamIDEndedSearch != 0){
+			Dictionary details;
+			details["reason"] = "ended";
+			details["ended_search_id"] = steamIDEndedSearch;
+			setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_CANCELLED, details);
+		}
+		else{
+			setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_SEARCHING, search_progress);
+		}
+	}
 }
 
 //! Notification to all players searching that a game has been found.
@@ -9195,6 +11820,38 @@ void Steam::search_for_game_result(SearchForGameResultCallback_t* call_data){
 	search_result["host_id"] = host_id;
 	search_result["final_callback"] = call_data->m_bFinalCallback;
 	emit_signal("search_for_game_result", result, search_id, search_result);
+	// Feed a running startGameSearch, accepting here rather than waiting on script
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_PLAYER];
+	if(run.state != GAME_SEARCH_STATE_SEARCHING && run.state != GAME_SEARCH_STATE_FOUND && run.state != GAME_SEARCH_STATE_ACCEPTED){
+		return;
+	}
+	if(!isCurrentGameSearch(GAME_SEARCH_ROLE_PLAYER, search_id)){
+		return;
+	}
+	run.search_id = search_id;
+	run.host_id = host_id;
+	if(result != k_EResultOK){
+		retryGameSearch(GAME_SEARCH_ROLE_PLAYER, "result_" + itos(result));
+	}
+	else if(call_data->m_bFinalCallback){
+		if(host_id == 0){
+			retryGameSearch(GAME_SEARCH_ROLE_PLAYER, "no_host");
+			return;
+		}
+		search_result["connection_details"] = retrieveConnectionDetails(host_id);
+		setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_READY, search_result);
+	}
+	else if(run.state == GAME_SEARCH_STATE_SEARCHING){
+		if(run.settings.get("auto_accept", false) && SteamGameSearch()->AcceptGame() == k_EGameSearchErrorCode_OK){
+			setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_ACCEPTED, search_result);
+		}
+		else{
+			setGameSearchState(GAME_SEARCH_ROLE_PLAYER, GAME_SEARCH_STATE_FOUND, search_result);
+		}
+	}
+	else{
+		setGameSearchState(GAME_SEARCH_ROLE_PLAYER, run.state, search_result);
+	}
 }
 
 //! Callback from RequestPlayersForGame when the matchmaking service has started or ended search; callback will also follow a call from CancelRequestPlayersForGame - m_bSearchInProgress will be false.
@@ -9202,6 +11859,14 @@ void Steam::request_players_for_game_progress(RequestPlayersForGameProgressCallb
 	EResult result = call_data->m_eResult;
 	uint64_t search_id = call_data->m_ullSearchID;
 	emit_signal("request_players_for_game_progress", result, search_id);
+	// Feed a running startGameHostSearch
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_HOST];
+	if(run.state == GAME_SEARCH_STATE_SEARCHING && isCurrentGameSearch(GAME_SEARCH_ROLE_HOST, search_id)){
+		run.search_id = search_id;
+		if(result != k_EResultOK){
+			retryGameSearch(GAME_SEARCH_ROLE_HOST, "result_" + itos(result));
+		}
+	}
 }
 
 //! Callback from RequestPlayersForGame, one of these will be sent per player followed by additional callbacks when players accept or decline the game.
@@ -9223,6 +11888,33 @@ void Steam::request_players_for_game_result(RequestPlayersForGameResultCallback_
 	player_data["unique_game_id"] = unique_game_id;
 	// Send the data back via signal
 	emit_signal("request_players_for_game_result", result, search_id, player_data);
+	// Track each player's answer for a running startGameHostSearch, confirming as soon as everyone accepted
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_HOST];
+	if(run.state != GAME_SEARCH_STATE_SEARCHING && run.state != GAME_SEARCH_STATE_FOUND){
+		return;
+	}
+	if(!isCurrentGameSearch(GAME_SEARCH_ROLE_HOST, search_id)){
+		return;
+	}
+	if(result != k_EResultOK){
+		retryGameSearch(GAME_SEARCH_ROLE_HOST, "result_" + itos(result));
+		return;
+	}
+	run.search_id = search_id;
+	run.game_id = unique_game_id;
+	GameSearchPlayer &player = run.players[player_id];
+	player.accept_state = call_data->m_ePlayerAcceptState;
+	player.team = call_data->m_nSuggestedTeamIndex;
+	player.lobby_id = lobby_id;
+	int player_min = run.settings.get("player_min", 1);
+	int accepted = call_data->m_nTotalPlayersAcceptedGame;
+	if(run.settings.get("auto_confirm", false) && accepted >= call_data->m_nTotalPlayersFound && accepted >= player_min){
+		if(SteamGameSearch()->HostConfirmGameStart(unique_game_id) == k_EGameSearchErrorCode_OK){
+			setGameSearchState(GAME_SEARCH_ROLE_HOST, GAME_SEARCH_STATE_ACCEPTED, player_data);
+			return;
+		}
+	}
+	setGameSearchState(GAME_SEARCH_ROLE_HOST, GAME_SEARCH_STATE_FOUND, player_data);
 }
 
 //! There are no notes about this in Valve's header files or documentation.
@@ -9231,6 +11923,20 @@ void Steam::request_players_for_game_final_result(RequestPlayersForGameFinalResu
 	uint64_t search_id = call_data->m_ullSearchID;
 	uint64_t game_id = call_data->m_ullUniqueGameID;
 	emit_signal("request_players_for_game_final", result, search_id, game_id);
+	// Finish a running startGameHostSearch
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_HOST];
+	if(run.state != GAME_SEARCH_STATE_SEARCHING && run.state != GAME_SEARCH_STATE_FOUND && run.state != GAME_SEARCH_STATE_ACCEPTED){
+		return;
+	}
+	if(!isCurrentGameSearch(GAME_SEARCH_ROLE_HOST, search_id)){
+		return;
+	}
+	if(result != k_EResultOK){
+		retryGameSearch(GAME_SEARCH_ROLE_HOST, "result_" + itos(result));
+		return;
+	}
+	run.game_id = game_id;
+	setGameSearchState(GAME_SEARCH_ROLE_HOST, GAME_SEARCH_STATE_READY);
 }
 
 //! This callback confirms that results were received by the matchmaking service for this player.
@@ -9246,6 +11952,10 @@ void Steam::end_game_result(EndGameResultCallback_t* call_data){
 	EResult result = call_data->m_eResult;
 	uint64_t game_id = call_data->ullUniqueGameID;
 	emit_signal("end_game_result", result, game_id);
+	GameSearchRun &run = game_search_runs[GAME_SEARCH_ROLE_HOST];
+	if(run.state == GAME_SEARCH_STATE_READY && run.game_id == game_id && result == k_EResultOK){
+		setGameSearchState(GAME_SEARCH_ROLE_HOST, GAME_SEARCH_STATE_ENDED);
+	}
 }
 
 // HTML SURFACE CALLBACKS ///////////////////////
@@ -9283,8 +11993,14 @@ void Steam::html_file_open_dialog(HTML_FileOpenDialog_t* call_data){
 	const String& title = call_data->pchTitle;
 	const String& initial_file = call_data->pchInitialFile;
 	// Allows you to react to a page wanting to open a file load dialog. NOTE: You MUST call this in response to a HTML_FileOpenDialog_t callback.
-	// So it is added here unless there is a case to use it separately.
-	SteamHTMLSurface()->FileLoadDialogResponse(browser_handle, &call_data->pchInitialFile);
+	// So it is added here unless there is a case to use it separately; a SteamHTMLRect answers for its own browser.
+	std::map<uint32, SteamHTMLRect*>::iterator rect = html_rects.find(browser_handle);
+	if(rect != html_rects.end()){
+		rect->second->file_open_dialog();
+	}
+	else{
+		SteamHTMLSurface()->FileLoadDialogResponse(browser_handle, &call_data->pchInitialFile);
+	}
 	// Send the signal back to the user
 	emit_signal("html_file_open_dialog", browser_handle, title, initial_file);
 }
@@ -9320,6 +12036,10 @@ void Steam::html_horizontal_scroll(HTML_HorizontalScroll_t* call_data){
 void Steam::html_js_alert(HTML_JSAlert_t* call_data){
 	browser_handle = call_data->unBrowserHandle;
 	const String& message = call_data->pchMessage;
+	std::map<uint32, SteamHTMLRect*>::iterator rect = html_rects.find(browser_handle);
+	if(rect != html_rects.end()){
+		rect->second->js_dialog(false);
+	}
 	emit_signal("html_js_alert", browser_handle, message);
 }
 
@@ -9327,6 +12047,10 @@ void Steam::html_js_alert(HTML_JSAlert_t* call_data){
 void Steam::html_js_confirm(HTML_JSConfirm_t* call_data){
 	browser_handle = call_data->unBrowserHandle;
 	const String& message = call_data->pchMessage;
+	std::map<uint32, SteamHTMLRect*>::iterator rect = html_rects.find(browser_handle);
+	if(rect != html_rects.end()){
+		rect->second->js_dialog(true);
+	}
 	emit_signal("html_js_confirm", browser_handle, message);
 }
 
@@ -9346,6 +12070,11 @@ void Steam::html_link_at_position(HTML_LinkAtPosition_t* call_data){
 //! Called when a browser surface has a pending paint. This is where you get the actual image data to render to the screen.
 void Steam::html_needs_paint(HTML_NeedsPaint_t* call_data){
 	browser_handle = call_data->unBrowserHandle;
+	// Copy the dirty rectangle into the browser's texture, if it has one
+	std::map<uint32, SteamHTMLTexture*>::iterator texture = html_textures.find(browser_handle);
+	if(texture != html_textures.end()){
+		texture->second->paint((const uint8_t*)call_data->pBGRA, call_data->unWide, call_data->unTall, call_data->unUpdateX, call_data->unUpdateY, call_data->unUpdateWide, call_data->unUpdateTall);
+	}
 	// Create dictionary to bypass Godot argument limit
 	Dictionary page_data;
 	page_data["bgra"] = call_data->pBGRA;
@@ -9412,6 +12141,11 @@ void Steam::html_start_request(HTML_StartRequest_t* call_data){
 	const String& target = call_data->pchTarget;
 	const String& post_data = call_data->pchPostData;
 	bool redirect = call_data->bIsRedirect;
+	// A SteamHTMLRect answers for its own browser
+	std::map<uint32, SteamHTMLRect*>::iterator rect = html_rects.find(browser_handle);
+	if(rect != html_rects.end()){
+		rect->second->start_request(url, target, post_data, redirect);
+	}
 	emit_signal("html_start_request", browser_handle, url, target, post_data, redirect);
 }
 
@@ -9631,6 +12365,38 @@ void Steam::lobby_message(LobbyChatMsg_t* call_data){
 	int size = SteamMatchmaking()->GetLobbyChatEntry(lobby_id, call_data->m_iChatID, &user_id, &buffer, STEAM_LARGE_BUFFER_SIZE, &type);
 	uint64_t lobby = lobby_id.ConvertToUint64();
 	uint64_t user = user_id.ConvertToUint64();
+	// Binary entries start with a zero byte followed by their frame kind
+	if(size >= 2 && buffer[0] == 0){
+		const uint8_t* frame = (const uint8_t*)buffer + 2;
+		int frame_size = size - 2;
+		if(buffer[1] == LOBBY_CHAT_FRAME_BINARY){
+			PoolByteArray data;
+			data.resize(frame_size);
+			if(frame_size > 0){
+				memcpy(data.write().ptr(), frame, frame_size);
+			}
+			emit_signal("lobby_message_binary", lobby, user, data);
+		}
+		else if(buffer[1] == LOBBY_CHAT_FRAME_BATCH){
+			int offset = 0;
+			while(offset + 2 <= frame_size){
+				int length = frame[offset] | (frame[offset + 1] << 8);
+				offset += 2;
+				if(length > frame_size - offset){
+					printf("[Steam] Truncated lobby chat batch from %llu.\n", (unsigned long long)user);
+					break;
+				}
+				PoolByteArray data;
+				data.resize(length);
+				if(length > 0){
+					memcpy(data.write().ptr(), frame + offset, length);
+				}
+				offset += length;
+				emit_signal("lobby_message_binary", lobby, user, data);
+			}
+		}
+		return;
+	}
 	emit_signal("lobby_message", lobby, user, String::utf8(buffer, size), chat_type);
 }
 
@@ -9640,6 +12406,16 @@ void Steam::lobby_chat_update(LobbyChatUpdate_t* call_data){
 	uint64_t changed_id = call_data->m_ulSteamIDUserChanged;
 	uint64_t making_change_id = call_data->m_ulSteamIDMakingChange;
 	uint32 chat_state = call_data->m_rgfChatMemberStateChange;
+	std::unordered_map<uint64_t, LobbyMirror>::iterator mirror = lobby_mirrors.find(lobby_id);
+	if(mirror != lobby_mirrors.end()){
+		if(chat_state & k_EChatMemberStateChangeEntered){
+			std::set<String> changed;
+			mirrorLobbyMemberData(lobby_id, changed_id, changed);
+		}
+		else{
+			mirror->second.members.erase(changed_id);
+		}
+	}
 	emit_signal("lobby_chat_update", lobby_id, changed_id, making_change_id, chat_state);
 }
 
@@ -9648,6 +12424,23 @@ void Steam::lobby_data_update(LobbyDataUpdate_t* call_data){
 	uint64_t member_id = call_data->m_ulSteamIDMember;
 	uint64_t lobby_id = call_data->m_ulSteamIDLobby;
 	uint8 success = call_data->m_bSuccess;
+	// Diff joined lobbies against their mirror and report only the keys that changed
+	if(success && lobby_mirrors.count(lobby_id) > 0){
+		std::set<String> changed;
+		if(member_id == lobby_id){
+			mirrorLobbyData(lobby_id, changed);
+		}
+		else{
+			mirrorLobbyMemberData(lobby_id, member_id, changed);
+		}
+		if(!changed.empty()){
+			PoolStringArray keys;
+			for(std::set<String>::iterator key = changed.begin(); key != changed.end(); ++key){
+				keys.append(*key);
+			}
+			emit_signal("lobby_data_changed", lobby_id, member_id, keys);
+		}
+	}
 	emit_signal("lobby_data_update", success, lobby_id, member_id);
 }
 
@@ -9658,6 +12451,7 @@ void Steam::lobby_kicked(LobbyKicked_t* call_data){
 	CSteamID steam_admin_id = call_data->m_ulSteamIDAdmin;
 	uint64_t admin_id = steam_admin_id.ConvertToUint64();
 	uint8 due_to_disconnect = call_data->m_bKickedDueToDisconnect;
+	lobby_mirrors.erase(lobby_id);
 	emit_signal("lobby_kicked", lobby_id, admin_id, due_to_disconnect);
 }
 
@@ -9668,6 +12462,15 @@ void Steam::lobby_joined(LobbyEnter_t* lobbyData){
 	uint32_t permissions = lobbyData->m_rgfChatPermissions;
 	bool locked = lobbyData->m_bLocked;
 	uint32_t response = lobbyData->m_EChatRoomEnterResponse;
+	// Start mirroring the lobby and its members' data
+	if(response == k_EChatRoomEnterResponseSuccess && SteamMatchmaking() != NULL){
+		std::set<String> changed;
+		mirrorLobbyData(lobby_id, changed);
+		int member_count = SteamMatchmaking()->GetNumLobbyMembers(steam_lobby_id);
+		for(int i = 0; i < member_count; i++){
+			mirrorLobbyMemberData(lobby_id, SteamMatchmaking()->GetLobbyMemberByIndex(steam_lobby_id, i).ConvertToUint64(), changed);
+		}
+	}
 	emit_signal("lobby_joined", lobby_id, permissions, locked, response);
 }
 
@@ -9771,6 +12574,13 @@ void Steam::p2p_session_request(P2PSessionRequest_t* call_data){
 //! Posted when a remote host is sending us a message, and we do not already have a session with them.
 void Steam::network_messages_session_request(SteamNetworkingMessagesSessionRequest_t* call_data){
 	SteamNetworkingIdentity remote = call_data->m_identityRemote;
+	// Accept natively if the session accept policy allows this user
+	if(session_accept_policy != SESSION_ACCEPT_NONE && isSessionAllowed(remote.GetSteamID64())){
+		if(SteamNetworkingMessages()->AcceptSessionWithUser(remote)){
+			touchSession(remote.GetSteamID64());
+			return;
+		}
+	}
 	char identity[STEAM_BUFFER_SIZE];
 	remote.ToString(identity, STEAM_BUFFER_SIZE);
 	emit_signal("network_messages_session_request", identity);
@@ -9810,6 +12620,32 @@ void Steam::network_connection_status_changed(SteamNetConnectionStatusChangedCal
 	connection["debug_description"] = connection_info.m_szConnectionDescription;
 	// Previous state (current state is in m_info.m_eState).
 	int old_state = call_data->m_eOldState;
+	// Keep the native connection table current; connections are dropped once Steam has destroyed them
+	if(connection_info.m_eState == k_ESteamNetworkingConnectionState_None){
+		tracked_connections.erase(call_data->m_hConn);
+		untracked_poll_groups.erase(call_data->m_hConn);
+	}
+	else{
+		bool is_new = tracked_connections.find(call_data->m_hConn) == tracked_connections.end();
+		TrackedConnection &tracked = tracked_connections[call_data->m_hConn];
+		tracked.state = connection_info.m_eState;
+		tracked.end_reason = connection_info.m_eEndReason;
+		tracked.listen_socket = connection_info.m_hListenSocket;
+		tracked.steam_id = connection_info.m_identityRemote.GetSteamID64();
+		tracked.user_data = (uint64_t)connection_info.m_nUserData;
+		tracked.identity = identity;
+		// Keep a poll group set before this first callback
+		if(is_new){
+			std::unordered_map<uint32, uint32>::iterator untracked = untracked_poll_groups.find(call_data->m_hConn);
+			if(untracked != untracked_poll_groups.end()){
+				tracked.poll_group = untracked->second;
+				untracked_poll_groups.erase(untracked);
+			}
+			else{
+				tracked.poll_group = 0;
+			}
+		}
+	}
 	// Send the data back via signal
 	emit_signal("network_connection_status_changed", connect_handle, connection, old_state);
 }
@@ -9889,6 +12725,44 @@ void Steam::available_beacon_locations_updated(AvailableBeaconLocationsUpdated_t
 //! Notification that the list of active beacons visible to the current user has changed. 
 void Steam::active_beacons_updated(ActiveBeaconsUpdated_t* call_data){
 	emit_signal("active_beacons_updated");
+	// Refresh the beacon snapshot and send only what changed
+	if(!beacons_snapshot_active || SteamParties() == NULL){
+		return;
+	}
+	std::unordered_map<uint64_t, uint32_t> previous_index;
+	for(uint32_t i = 0; i < beacons_snapshot.size(); i++){
+		previous_index[beacons_snapshot[i].beacon_id] = i;
+	}
+	std::vector<BeaconSnapshotEntry> previous;
+	previous.swap(beacons_snapshot);
+	readBeaconsSnapshot(beacons_snapshot, previous, previous_index);
+	std::vector<uint32_t> changed;
+	Array added;
+	for(uint32_t i = 0; i < beacons_snapshot.size(); i++){
+		const BeaconSnapshotEntry &entry = beacons_snapshot[i];
+		std::unordered_map<uint64_t, uint32_t>::iterator found = previous_index.find(entry.beacon_id);
+		if(found == previous_index.end()){
+			changed.push_back(i);
+			added.append((uint64_t)entry.beacon_id);
+			continue;
+		}
+		const BeaconSnapshotEntry &old_entry = previous[found->second];
+		if(old_entry.owner_id != entry.owner_id || old_entry.type != entry.type || old_entry.location_id != entry.location_id || old_entry.metadata != entry.metadata){
+			changed.push_back(i);
+		}
+		previous_index.erase(found);
+	}
+	Array removed;
+	for(std::unordered_map<uint64_t, uint32_t>::iterator gone = previous_index.begin(); gone != previous_index.end(); ++gone){
+		removed.append((uint64_t)gone->first);
+	}
+	if(changed.empty() && removed.empty()){
+		return;
+	}
+	Dictionary changes = packBeaconsSnapshot(changed);
+	changes["added"] = added;
+	changes["removed"] = removed;
+	emit_signal("beacons_snapshot_changed", changes);
 }
 
 // REMOTE PLAY CALLBACKS ////////////////////////
@@ -10341,6 +13215,39 @@ void Steam::lobby_match_list(LobbyMatchList_t *call_data, bool io_failure){
 			lobbies.append(lobby);
 		}
 		emit_signal("lobby_match_list", lobbies);
+		// Build the prefetched table in one pass while the results are fresh
+		if(!lobby_list_prefetch_keys.empty()){
+			PoolIntArray members;
+			PoolIntArray member_limits;
+			members.resize(lobby_count);
+			member_limits.resize(lobby_count);
+			std::vector<PoolStringArray> values(lobby_list_prefetch_keys.size());
+			for(uint32_t k = 0; k < values.size(); k++){
+				values[k].resize(lobby_count);
+			}
+			{
+				PoolIntArray::Write members_write = members.write();
+				PoolIntArray::Write member_limits_write = member_limits.write();
+				for(int i = 0; i < lobby_count; i++){
+					CSteamID lobby_id = (uint64)(uint64_t)lobbies[i];
+					members_write[i] = SteamMatchmaking()->GetNumLobbyMembers(lobby_id);
+					member_limits_write[i] = SteamMatchmaking()->GetLobbyMemberLimit(lobby_id);
+					for(uint32_t k = 0; k < lobby_list_prefetch_keys.size(); k++){
+						values[k].set(i, String::utf8(SteamMatchmaking()->GetLobbyData(lobby_id, lobby_list_prefetch_keys[k].get_data())));
+					}
+				}
+			}
+			Dictionary data;
+			for(uint32_t k = 0; k < lobby_list_prefetch_keys.size(); k++){
+				data[String::utf8(lobby_list_prefetch_keys[k].get_data())] = values[k];
+			}
+			Dictionary table;
+			table["lobby_ids"] = lobbies;
+			table["members"] = members;
+			table["member_limits"] = member_limits;
+			table["data"] = data;
+			emit_signal("lobby_match_table", table);
+		}
 	}
 }
 
@@ -11050,10 +13957,15 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("activateGameOverlayToStore", "app_id"), &Steam::activateGameOverlayToStore, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("activateGameOverlayToUser", "type", "steam_id"), &Steam::activateGameOverlayToUser, DEFVAL(""), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("activateGameOverlayToWebPage", "url"), &Steam::activateGameOverlayToWebPage);
+	ClassDB::bind_method("clearAvatarAtlas", &Steam::clearAvatarAtlas);
+	ClassDB::bind_method("clearAvatarCache", &Steam::clearAvatarCache);
 	ClassDB::bind_method("clearRichPresence", &Steam::clearRichPresence);
 	ClassDB::bind_method(D_METHOD("closeClanChatWindowInSteam", "chat_id"), &Steam::closeClanChatWindowInSteam);
 	ClassDB::bind_method(D_METHOD("downloadClanActivityCounts", "chat_id", "clans_to_request"), &Steam::downloadClanActivityCounts);
 	ClassDB::bind_method(D_METHOD("enumerateFollowingList", "start_index"), &Steam::enumerateFollowingList);
+	ClassDB::bind_method("flushRichPresence", &Steam::flushRichPresence);
+	ClassDB::bind_method(D_METHOD("getAvatarAtlasRegion", "steam_id", "size"), &Steam::getAvatarAtlasRegion, DEFVAL(0), DEFVAL(2));
+	ClassDB::bind_method(D_METHOD("getAvatarTexture", "steam_id", "size"), &Steam::getAvatarTexture, DEFVAL(0), DEFVAL(2));
 	ClassDB::bind_method(D_METHOD("getChatMemberByIndex", "clan_id", "user"), &Steam::getChatMemberByIndex);
 	ClassDB::bind_method(D_METHOD("getClanActivityCounts", "clan_id"), &Steam::getClanActivityCounts);
 	ClassDB::bind_method(D_METHOD("getClanByIndex", "clan"), &Steam::getClanByIndex);
@@ -11088,6 +14000,9 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("getFriendsGroupMembersCount", "friend_group"), &Steam::getFriendsGroupMembersCount);
 	ClassDB::bind_method(D_METHOD("getFriendsGroupMembersList", "friend_group", "member_count"), &Steam::getFriendsGroupMembersList);
 	ClassDB::bind_method(D_METHOD("getFriendsGroupName", "friend_group"), &Steam::getFriendsGroupName);
+	ClassDB::bind_method(D_METHOD("getFriendsRichPresence", "steam_ids"), &Steam::getFriendsRichPresence);
+	ClassDB::bind_method("getFriendsRichPresenceChanges", &Steam::getFriendsRichPresenceChanges);
+	ClassDB::bind_method(D_METHOD("getFriendsSnapshot", "friend_flags"), &Steam::getFriendsSnapshot, DEFVAL(0x04));
 	ClassDB::bind_method(D_METHOD("getFriendSteamLevel", "steam_id"), &Steam::getFriendSteamLevel);
 	ClassDB::bind_method(D_METHOD("getLargeFriendAvatar", "steam_id"), &Steam::getLargeFriendAvatar);
 	ClassDB::bind_method(D_METHOD("getMediumFriendAvatar", "steam_id"), &Steam::getMediumFriendAvatar);
@@ -11121,11 +14036,14 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("requestFriendRichPresence", "friend_id"), &Steam::requestFriendRichPresence);
 	ClassDB::bind_method(D_METHOD("requestUserInformation", "steam_id", "require_name_only"), &Steam::requestUserInformation);
 	ClassDB::bind_method(D_METHOD("sendClanChatMessage", "chat_id", "text"), &Steam::sendClanChatMessage);
+	ClassDB::bind_method(D_METHOD("setAvatarAtlasSize", "max_slots"), &Steam::setAvatarAtlasSize);
+	ClassDB::bind_method(D_METHOD("setAvatarCacheSize", "max_entries"), &Steam::setAvatarCacheSize);
 	ClassDB::bind_method(D_METHOD("setInGameVoiceSpeaking", "steam_id", "speaking"), &Steam::setInGameVoiceSpeaking);
 	ClassDB::bind_method(D_METHOD("setListenForFriendsMessages", "intercept"), &Steam::setListenForFriendsMessages);
 	ClassDB::bind_method(D_METHOD("setPersonaName", "name"), &Steam::setPersonaName);
 	ClassDB::bind_method(D_METHOD("setPlayedWith", "steam_id"), &Steam::setPlayedWith);	
 	ClassDB::bind_method(D_METHOD("setRichPresence", "key", "value"), &Steam::setRichPresence);
+	ClassDB::bind_method(D_METHOD("setRichPresenceFlushInterval", "interval"), &Steam::setRichPresenceFlushInterval);
 	
 	// GAME SEARCH BIND METHODS /////////////////
 	ClassDB::bind_method(D_METHOD("addGameSearchParams", "key", "values"), &Steam::addGameSearchParams);
@@ -11142,6 +14060,10 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method("cancelRequestPlayersForGame", &Steam::cancelRequestPlayersForGame);
 	ClassDB::bind_method(D_METHOD("submitPlayerResult", "game_id", "player_id", "player_result"), &Steam::submitPlayerResult);
 	ClassDB::bind_method(D_METHOD("endGame", "game_id"), &Steam::endGame);
+	ClassDB::bind_method(D_METHOD("startGameSearch", "settings"), &Steam::startGameSearch);
+	ClassDB::bind_method(D_METHOD("startGameHostSearch", "settings"), &Steam::startGameHostSearch);
+	ClassDB::bind_method(D_METHOD("cancelGameSearch", "role"), &Steam::cancelGameSearch);
+	ClassDB::bind_method(D_METHOD("getGameSearchStatus", "role"), &Steam::getGameSearchStatus);
 
 	// HTML SURFACE BIND METHODS ////////////////
 	ClassDB::bind_method(D_METHOD("addHeader", "key", "value", "this_handle"), &Steam::addHeader, DEFVAL(0));
@@ -11295,13 +14217,14 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method("getFavoriteGames", &Steam::getFavoriteGames);
 	ClassDB::bind_method(D_METHOD("addFavoriteGame", "ip", "port", "query_port", "flags", "last_played"), &Steam::addFavoriteGame);
 	ClassDB::bind_method(D_METHOD("removeFavoriteGame", "app_id", "ip", "port", "query_port", "flags"), &Steam::removeFavoriteGame);
-	ClassDB::bind_method("requestLobbyList", &Steam::requestLobbyList);
+	ClassDB::bind_method(D_METHOD("requestLobbyList", "prefetch_keys"), &Steam::requestLobbyList, DEFVAL(PoolStringArray()));
 	ClassDB::bind_method(D_METHOD("addRequestLobbyListStringFilter", "key_to_match", "value_to_match", "comparison_type"), &Steam::addRequestLobbyListStringFilter);
 	ClassDB::bind_method(D_METHOD("addRequestLobbyListNumericalFilter", "key_to_match", "value_to_match", "comparison_type"), &Steam::addRequestLobbyListNumericalFilter);
 	ClassDB::bind_method(D_METHOD("addRequestLobbyListNearValueFilter", "key_to_match", "value_to_be_close_to"), &Steam::addRequestLobbyListNearValueFilter);
 	ClassDB::bind_method(D_METHOD("addRequestLobbyListFilterSlotsAvailable", "slots_available"), &Steam::addRequestLobbyListFilterSlotsAvailable);
 	ClassDB::bind_method(D_METHOD("addRequestLobbyListDistanceFilter", "distance_filter"), &Steam::addRequestLobbyListDistanceFilter);
 	ClassDB::bind_method(D_METHOD("addRequestLobbyListResultCountFilter", "max_results"), &Steam::addRequestLobbyListResultCountFilter);
+	ClassDB::bind_method(D_METHOD("rankLobbies", "lobby_ids", "weights"), &Steam::rankLobbies);
 	ClassDB::bind_method(D_METHOD("createLobby", "lobby_type", "max_members"), &Steam::createLobby, DEFVAL(2));
 	ClassDB::bind_method(D_METHOD("joinLobby", "steam_lobby_id"), &Steam::joinLobby);
 	ClassDB::bind_method(D_METHOD("leaveLobby", "steam_lobby_id"), &Steam::leaveLobby);
@@ -11311,10 +14234,15 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("getLobbyData", "steam_lobby_id", "key"), &Steam::getLobbyData);
 	ClassDB::bind_method(D_METHOD("setLobbyData", "steam_lobby_id", "key", "value"), &Steam::setLobbyData);
 	ClassDB::bind_method(D_METHOD("getAllLobbyData", "steam_lobby_id"), &Steam::getAllLobbyData);
+	ClassDB::bind_method(D_METHOD("getLobbyDataMirror", "steam_lobby_id"), &Steam::getLobbyDataMirror);
 	ClassDB::bind_method(D_METHOD("deleteLobbyData", "steam_lobby_id", "key"), &Steam::deleteLobbyData);
 	ClassDB::bind_method(D_METHOD("getLobbyMemberData", "steam_lobby_id", "steam_id_user", "key"), &Steam::getLobbyMemberData);
 	ClassDB::bind_method(D_METHOD("setLobbyMemberData", "steam_lobby_id", "key", "value"), &Steam::setLobbyMemberData);
+	ClassDB::bind_method(D_METHOD("setLobbyMemberDataKeys", "keys"), &Steam::setLobbyMemberDataKeys);
 	ClassDB::bind_method(D_METHOD("sendLobbyChatMsg", "steam_lobby_id", "message_body"), &Steam::sendLobbyChatMsg);
+	ClassDB::bind_method(D_METHOD("sendLobbyChatBinary", "steam_lobby_id", "data"), &Steam::sendLobbyChatBinary);
+	ClassDB::bind_method(D_METHOD("queueLobbyChatBinary", "steam_lobby_id", "data"), &Steam::queueLobbyChatBinary);
+	ClassDB::bind_method(D_METHOD("flushLobbyChat", "steam_lobby_id"), &Steam::flushLobbyChat, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("requestLobbyData", "steam_lobby_id"), &Steam::requestLobbyData);
 	ClassDB::bind_method(D_METHOD("setLobbyGameServer", "steam_lobby_id", "server_ip", "server_port", "steam_id_game_server"), &Steam::setLobbyGameServer);
 	ClassDB::bind_method(D_METHOD("getLobbyGameServer", "steam_lobby_id"), &Steam::getLobbyGameServer);
@@ -11327,12 +14255,17 @@ void Steam::_bind_methods(){
 
 	// MATCHMAKING SERVERS BIND METHODS /////////
 	ClassDB::bind_method(D_METHOD("cancelQuery", "server_list_request"), &Steam::cancelQuery);
+	ClassDB::bind_method("cancelServerQueries", &Steam::cancelServerQueries);
 	ClassDB::bind_method(D_METHOD("cancelServerQuery", "server_query"), &Steam::cancelServerQuery);
 	ClassDB::bind_method(D_METHOD("getServerCount", "server_list_request"), &Steam::getServerCount);
 	ClassDB::bind_method(D_METHOD("getServerDetails", "server", "server_list_request"), &Steam::getServerDetails);
+	ClassDB::bind_method("getServerListCount", &Steam::getServerListCount);
+	ClassDB::bind_method(D_METHOD("getServerListPage", "offset", "count"), &Steam::getServerListPage);
+	ClassDB::bind_method("getServerQueryStatus", &Steam::getServerQueryStatus);
 	ClassDB::bind_method(D_METHOD("isRefreshing", "server_list_request"), &Steam::isRefreshing);
 	ClassDB::bind_method(D_METHOD("pingServer", "ip", "port"), &Steam::pingServer);
 	ClassDB::bind_method(D_METHOD("playerDetails", "ip", "port"), &Steam::playerDetails);
+	ClassDB::bind_method(D_METHOD("queueServerQuery", "ip", "port", "kinds", "priority"), &Steam::queueServerQuery, DEFVAL(SERVER_QUERY_PING), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("refreshQuery", "server_list_request"), &Steam::refreshQuery);
 	ClassDB::bind_method(D_METHOD("refreshServer", "server", "server_list_request"), &Steam::refreshServer);
 	ClassDB::bind_method(D_METHOD("releaseRequest", "server_list_request"), &Steam::releaseRequest);
@@ -11343,6 +14276,10 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("requestLANServerList", "app_id"), &Steam::requestLANServerList);
 	ClassDB::bind_method(D_METHOD("requestSpectatorServerList", "app_id", "filters"), &Steam::requestSpectatorServerList);
 	ClassDB::bind_method(D_METHOD("serverRules", "ip", "port"), &Steam::serverRules);
+	ClassDB::bind_method(D_METHOD("setServerListCache", "path"), &Steam::setServerListCache);
+	ClassDB::bind_method(D_METHOD("setServerListFilter", "filter"), &Steam::setServerListFilter);
+	ClassDB::bind_method(D_METHOD("setServerListSort", "field", "ascending"), &Steam::setServerListSort, DEFVAL(SERVER_SORT_PING), DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("setServerQueryLimits", "max_in_flight", "timeout"), &Steam::setServerQueryLimits, DEFVAL(8), DEFVAL(2.0));
 	
 	// MUSIC BIND METHODS ///////////////////////
 	ClassDB::bind_method("musicIsEnabled", &Steam::musicIsEnabled);
@@ -11401,11 +14338,18 @@ void Steam::_bind_methods(){
 
 	// NETWORKING MESSAGES BIND METHODS /////////
 	ClassDB::bind_method(D_METHOD("acceptSessionWithUser", "identity_reference"), &Steam::acceptSessionWithUser);
+	ClassDB::bind_method(D_METHOD("addSessionAllowlist", "steam_id"), &Steam::addSessionAllowlist);
+	ClassDB::bind_method("clearSessionAllowlist", &Steam::clearSessionAllowlist);
 	ClassDB::bind_method(D_METHOD("closeChannelWithUser", "identity_reference", "channel"), &Steam::closeChannelWithUser);
 	ClassDB::bind_method(D_METHOD("closeSessionWithUser", "identity_reference"), &Steam::closeSessionWithUser);
+	ClassDB::bind_method("getManagedSessions", &Steam::getManagedSessions);
 	ClassDB::bind_method(D_METHOD("getSessionConnectionInfo", "identity_reference", "get_connection", "get_status"), &Steam::getSessionConnectionInfo);
 	ClassDB::bind_method(D_METHOD("receiveMessagesOnChannel", "channel", "max_messages"), &Steam::receiveMessagesOnChannel);
+	ClassDB::bind_method(D_METHOD("receiveMessagesOnChannels", "channels", "max_messages"), &Steam::receiveMessagesOnChannels);
+	ClassDB::bind_method(D_METHOD("removeSessionAllowlist", "steam_id"), &Steam::removeSessionAllowlist);
 	ClassDB::bind_method(D_METHOD("sendMessageToUser", "identity_reference", "data", "flags", "channel"), &Steam::sendMessageToUser);
+	ClassDB::bind_method(D_METHOD("setSessionAcceptPolicy", "policy", "lobby_id"), &Steam::setSessionAcceptPolicy, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("setSessionIdleTimeout", "timeout"), &Steam::setSessionIdleTimeout);
 	
 	// NETWORKING SOCKETS BIND METHODS //////////
 	ClassDB::bind_method(D_METHOD("acceptConnection", "connection"), &Steam::acceptConnection);
@@ -11430,6 +14374,7 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("getConnectionInfo", "connection_handle"), &Steam::getConnectionInfo);
 	ClassDB::bind_method(D_METHOD("getConnectionName", "peer"), &Steam::getConnectionName);
 	ClassDB::bind_method(D_METHOD("getConnectionRealTimeStatus", "connection_handle", "lanes", "get_status"), &Steam::getConnectionRealTimeStatus, DEFVAL(true));
+	ClassDB::bind_method("getConnectionTable", &Steam::getConnectionTable);
 	ClassDB::bind_method(D_METHOD("getConnectionUserData", "peer"), &Steam::getConnectionUserData);
 	ClassDB::bind_method(D_METHOD("getDetailedConnectionStatus", "connection_handle"), &Steam::getDetailedConnectionStatus);
 	ClassDB::bind_method(D_METHOD("getFakeIP", "first_port"), &Steam::getFakeIP, DEFVAL(0));
@@ -11440,6 +14385,11 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("getListenSocketAddress", "socket"), &Steam::getListenSocketAddress);
 	ClassDB::bind_method("getIdentity", &Steam::getIdentity);
 	ClassDB::bind_method(D_METHOD("getRemoteFakeIPForConnection", "connection"), &Steam::getRemoteFakeIPForConnection);
+	ClassDB::bind_method(D_METHOD("getTrackedConnection", "connection"), &Steam::getTrackedConnection);
+	ClassDB::bind_method(D_METHOD("getTrackedConnectionIdentity", "connection"), &Steam::getTrackedConnectionIdentity);
+	ClassDB::bind_method(D_METHOD("getTrackedConnectionPollGroup", "connection"), &Steam::getTrackedConnectionPollGroup);
+	ClassDB::bind_method(D_METHOD("getTrackedConnectionState", "connection"), &Steam::getTrackedConnectionState);
+	ClassDB::bind_method(D_METHOD("getTrackedConnectionUserData", "connection"), &Steam::getTrackedConnectionUserData);
 	ClassDB::bind_method("initAuthentication", &Steam::initAuthentication);
 	ClassDB::bind_method(D_METHOD("receiveMessagesOnConnection", "connection", "max_messages"), &Steam::receiveMessagesOnConnection);	
 	ClassDB::bind_method(D_METHOD("receiveMessagesOnPollGroup", "poll_group", "max_messages"), &Steam::receiveMessagesOnPollGroup);
@@ -11451,6 +14401,7 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("setCertificate", "certificate"), &Steam::setCertificate);	
 	ClassDB::bind_method(D_METHOD("setConnectionPollGroup", "connection_handle", "poll_group"), &Steam::setConnectionPollGroup);
 	ClassDB::bind_method(D_METHOD("setConnectionName", "peer", "name"), &Steam::setConnectionName);
+	ClassDB::bind_method(D_METHOD("setConnectionUserData", "peer", "user_data"), &Steam::setConnectionUserData);
 	
 	// NETWORKING TYPES BIND METHODS ////////////
 	ClassDB::bind_method(D_METHOD("addIdentity", "reference_name"), &Steam::addIdentity);
@@ -11514,6 +14465,30 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("setGlobalConfigValueInt32", "config", "value"), &Steam::setGlobalConfigValueInt32);
 	ClassDB::bind_method(D_METHOD("setGlobalConfigValueString", "config", "value"), &Steam::setGlobalConfigValueString);
 	
+	// NETWORKING CAPTURE BIND METHODS /////////
+	ClassDB::bind_method("getMessageReplayStatus", &Steam::getMessageReplayStatus);
+	ClassDB::bind_method("isCapturingMessages", &Steam::isCapturingMessages);
+	ClassDB::bind_method("isReplayingMessages", &Steam::isReplayingMessages);
+	ClassDB::bind_method(D_METHOD("startMessageCapture", "path", "initial_size"), &Steam::startMessageCapture, DEFVAL(16777216));
+	ClassDB::bind_method(D_METHOD("startMessageReplay", "path", "speed"), &Steam::startMessageReplay, DEFVAL(1.0));
+	ClassDB::bind_method("stopMessageCapture", &Steam::stopMessageCapture);
+	ClassDB::bind_method("stopMessageReplay", &Steam::stopMessageReplay);
+
+	// NETWORKING TIME SYNC BIND METHODS ////////
+	ClassDB::bind_method("getServerTime", &Steam::getServerTime);
+	ClassDB::bind_method("getTimeSyncStatus", &Steam::getTimeSyncStatus);
+	ClassDB::bind_method("isTimeSynced", &Steam::isTimeSynced);
+	ClassDB::bind_method(D_METHOD("startTimeSync", "host_steam_id", "channel", "interval"), &Steam::startTimeSync, DEFVAL(255), DEFVAL(1.0));
+	ClassDB::bind_method("stopTimeSync", &Steam::stopTimeSync);
+
+	// NETWORKING TELEMETRY BIND METHODS ////////
+	ClassDB::bind_method("clearConnectionTelemetry", &Steam::clearConnectionTelemetry);
+	ClassDB::bind_method(D_METHOD("getConnectionTelemetry", "connection"), &Steam::getConnectionTelemetry);
+	ClassDB::bind_method("getConnectionTelemetrySummary", &Steam::getConnectionTelemetrySummary);
+	ClassDB::bind_method("isConnectionTelemetryActive", &Steam::isConnectionTelemetryActive);
+	ClassDB::bind_method(D_METHOD("startConnectionTelemetry", "interval", "history_size"), &Steam::startConnectionTelemetry, DEFVAL(0.1), DEFVAL(600));
+	ClassDB::bind_method("stopConnectionTelemetry", &Steam::stopConnectionTelemetry);
+
 	// PARENTAL SETTINGS BIND METHODS ///////////
 	ClassDB::bind_method("isParentalLockEnabled", &Steam::isParentalLockEnabled);
 	ClassDB::bind_method("isParentalLockLocked", &Steam::isParentalLockLocked);
@@ -11531,6 +14506,7 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("getBeaconByIndex", "index"), &Steam::getBeaconByIndex);
 	ClassDB::bind_method(D_METHOD("getBeaconDetails", "beacon_id"), &Steam::getBeaconDetails);
 	ClassDB::bind_method(D_METHOD("getBeaconLocationData", "location_id", "location_type", "location_data"), &Steam::getBeaconLocationData);
+	ClassDB::bind_method("getBeaconsSnapshot", &Steam::getBeaconsSnapshot);
 	ClassDB::bind_method("getNumActiveBeacons", &Steam::getNumActiveBeacons);
 	ClassDB::bind_method(D_METHOD("joinParty", "beacon_id"), &Steam::joinParty);
 	ClassDB::bind_method(D_METHOD("onReservationCompleted", "beacon_id", "steam_id"), &Steam::onReservationCompleted);
@@ -11776,6 +14752,7 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method("isSteamRunningInVR", &Steam::isSteamRunningInVR);
 	ClassDB::bind_method("isVRHeadsetStreamingEnabled", &Steam::isVRHeadsetStreamingEnabled);
 	ClassDB::bind_method("overlayNeedsPresent", &Steam::overlayNeedsPresent);
+	ClassDB::bind_method(D_METHOD("requestImageTexture", "image", "mipmaps"), &Steam::requestImageTexture, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("setOverlayNotificationInset", "horizontal", "vertical"), &Steam::setOverlayNotificationInset);
 	ClassDB::bind_method(D_METHOD("setOverlayNotificationPosition", "pos"), &Steam::setOverlayNotificationPosition);
 	ClassDB::bind_method(D_METHOD("setVRHeadsetStreamingEnabled", "enabled"), &Steam::setVRHeadsetStreamingEnabled);
@@ -11792,6 +14769,18 @@ void Steam::_bind_methods(){
 	ClassDB::bind_method(D_METHOD("getVideoURL", "app_id"), &Steam::getVideoURL);
 	ClassDB::bind_method("isBroadcasting", &Steam::isBroadcasting);
 
+	// VOICE BIND METHODS ///////////////////////
+	ClassDB::bind_method(D_METHOD("addVoicePeer", "steam_id"), &Steam::addVoicePeer);
+	ClassDB::bind_method("clearVoicePeers", &Steam::clearVoicePeers);
+	ClassDB::bind_method("getVoicePipelineSampleRate", &Steam::getVoicePipelineSampleRate);
+	ClassDB::bind_method(D_METHOD("getVoiceSpeakerStatus", "steam_id"), &Steam::getVoiceSpeakerStatus);
+	ClassDB::bind_method("isVoicePipelineActive", &Steam::isVoicePipelineActive);
+	ClassDB::bind_method(D_METHOD("removeVoicePeer", "steam_id"), &Steam::removeVoicePeer);
+	ClassDB::bind_method(D_METHOD("setVoiceJitterBuffer", "min_delay", "max_delay"), &Steam::setVoiceJitterBuffer, DEFVAL(0.04), DEFVAL(0.3));
+	ClassDB::bind_method(D_METHOD("setVoicePlayback", "steam_id", "playback"), &Steam::setVoicePlayback);
+	ClassDB::bind_method(D_METHOD("startVoicePipeline", "channel", "sample_rate"), &Steam::startVoicePipeline, DEFVAL(254), DEFVAL(0));
+	ClassDB::bind_method("stopVoicePipeline", &Steam::stopVoicePipeline);
+
 	/////////////////////////////////////////////
 	// CALLBACK SIGNAL BINDS
 	/////////////////////////////////////////////
@@ -11811,10 +14800,14 @@ void Steam::_bind_methods(){
 
 	// FRIENDS SIGNALS //////////////////////////
 	ADD_SIGNAL(MethodInfo("avatar_loaded", PropertyInfo(Variant::INT, "avatar_id"), PropertyInfo(Variant::INT, "size"), PropertyInfo(Variant::ARRAY, "data")));
+	ADD_SIGNAL(MethodInfo("avatar_atlas_evicted", PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::INT, "size")));
+	ADD_SIGNAL(MethodInfo("avatar_atlas_updated", PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::INT, "size"), PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "ImageTexture"), PropertyInfo(Variant::RECT2, "region")));
+	ADD_SIGNAL(MethodInfo("avatar_texture_loaded", PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::INT, "size"), PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "ImageTexture")));
 	ADD_SIGNAL(MethodInfo("avatar_image_loaded", PropertyInfo(Variant::INT, "avatar_id"), PropertyInfo(Variant::INT, "avatar_index"), PropertyInfo(Variant::INT, "width"), PropertyInfo(Variant::INT, "height")));
 	ADD_SIGNAL(MethodInfo("request_clan_officer_list", PropertyInfo(Variant::STRING, "message"), PropertyInfo(Variant::ARRAY, "officer_list")));
 	ADD_SIGNAL(MethodInfo("clan_activity_downloaded", PropertyInfo(Variant::DICTIONARY, "activity")));
 	ADD_SIGNAL(MethodInfo("friend_rich_presence_update", PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::INT, "app_id")));
+	ADD_SIGNAL(MethodInfo("friends_snapshot_changed", PropertyInfo(Variant::DICTIONARY, "changes")));
 	ADD_SIGNAL(MethodInfo("enumerate_following_list", PropertyInfo(Variant::STRING, "message"), PropertyInfo(Variant::ARRAY, "following")));
 	ADD_SIGNAL(MethodInfo("get_follower_count", PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::INT, "count")));
 	ADD_SIGNAL(MethodInfo("is_following", PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::BOOL, "following")));
@@ -11842,6 +14835,7 @@ void Steam::_bind_methods(){
 	ADD_SIGNAL(MethodInfo("request_players_for_game_final_result", PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "search_id"), PropertyInfo(Variant::INT, "game_id")));
 	ADD_SIGNAL(MethodInfo("submit_player_result", PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "game_id"), PropertyInfo(Variant::INT, "player_id")));
 	ADD_SIGNAL(MethodInfo("end_game_result", PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "game_id")));
+	ADD_SIGNAL(MethodInfo("game_search_state", PropertyInfo(Variant::INT, "role"), PropertyInfo(Variant::INT, "state"), PropertyInfo(Variant::DICTIONARY, "details")));
 
 	// HTML SURFACE SIGNALS /////////////////////
 	ADD_SIGNAL(MethodInfo("html_browser_ready", PropertyInfo(Variant::INT, "browser_handle")));
@@ -11891,18 +14885,24 @@ void Steam::_bind_methods(){
 	ADD_SIGNAL(MethodInfo("favorites_list_accounts_updated", PropertyInfo(Variant::INT, "result")));
 	ADD_SIGNAL(MethodInfo("favorites_list_changed", PropertyInfo(Variant::DICTIONARY, "favorite")));
 	ADD_SIGNAL(MethodInfo("lobby_message", PropertyInfo(Variant::INT, "lobby_id"), PropertyInfo(Variant::INT, "user"), PropertyInfo(Variant::STRING, "message"), PropertyInfo(Variant::INT, "chat_type")));
+	ADD_SIGNAL(MethodInfo("lobby_message_binary", PropertyInfo(Variant::INT, "lobby_id"), PropertyInfo(Variant::INT, "user"), PropertyInfo(Variant::POOL_BYTE_ARRAY, "data")));
 	ADD_SIGNAL(MethodInfo("lobby_chat_update", PropertyInfo(Variant::INT, "lobby_id"), PropertyInfo(Variant::INT, "changed_id"), PropertyInfo(Variant::INT, "making_change_id"), PropertyInfo(Variant::INT, "chat_state")));
 	ADD_SIGNAL(MethodInfo("lobby_created", PropertyInfo(Variant::INT, "connect"), PropertyInfo(Variant::INT, "lobby_id")));
+	ADD_SIGNAL(MethodInfo("lobby_data_changed", PropertyInfo(Variant::INT, "lobby_id"), PropertyInfo(Variant::INT, "member_id"), PropertyInfo(Variant::POOL_STRING_ARRAY, "keys")));
 	ADD_SIGNAL(MethodInfo("lobby_data_update"));
 	ADD_SIGNAL(MethodInfo("lobby_joined", PropertyInfo(Variant::INT, "lobby"), PropertyInfo(Variant::INT, "permissions"), PropertyInfo(Variant::BOOL, "locked"), PropertyInfo(Variant::INT, "response")));
 	ADD_SIGNAL(MethodInfo("lobby_game_created", PropertyInfo(Variant::INT, "lobby_id"), PropertyInfo(Variant::INT, "server_id"), PropertyInfo(Variant::STRING, "server_ip"), PropertyInfo(Variant::INT, "port")));
 	ADD_SIGNAL(MethodInfo("lobby_invite", PropertyInfo(Variant::INT, "inviter"), PropertyInfo(Variant::INT, "lobby"), PropertyInfo(Variant::INT, "game")));
 	ADD_SIGNAL(MethodInfo("lobby_match_list", PropertyInfo(Variant::ARRAY, "lobbies")));
+	ADD_SIGNAL(MethodInfo("lobby_match_table", PropertyInfo(Variant::DICTIONARY, "table")));
 	ADD_SIGNAL(MethodInfo("lobby_kicked", PropertyInfo(Variant::INT, "lobby_id"), PropertyInfo(Variant::INT, "admin_id"), PropertyInfo(Variant::INT, "due_to_disconnect")));
 	
 	// MATCHMAKING SERVER SIGNALS ///////////////
 	ADD_SIGNAL(MethodInfo("server_responded"));
 	ADD_SIGNAL(MethodInfo("server_failed_to_respond"));
+	ADD_SIGNAL(MethodInfo("server_list_updated", PropertyInfo(Variant::INT, "total")));
+	ADD_SIGNAL(MethodInfo("server_query_complete", PropertyInfo(Variant::STRING, "ip"), PropertyInfo(Variant::INT, "port"), PropertyInfo(Variant::DICTIONARY, "result")));
+	ADD_SIGNAL(MethodInfo("server_list_refresh_complete", PropertyInfo(Variant::INT, "server_list_request"), PropertyInfo(Variant::INT, "response")));
 
 	// MUSIC REMOTE SIGNALS /////////////////////
 	ADD_SIGNAL(MethodInfo("music_player_remote_to_front"));
@@ -11927,6 +14927,7 @@ void Steam::_bind_methods(){
 	// NETWORKING MESSAGES //////////////////////
 	ADD_SIGNAL(MethodInfo("network_messages_session_request", PropertyInfo(Variant::STRING, "identity")));
 	ADD_SIGNAL(MethodInfo("network_messages_session_failed", PropertyInfo(Variant::INT, "reason")));
+	ADD_SIGNAL(MethodInfo("network_messages_session_culled", PropertyInfo(Variant::INT, "steam_id"), PropertyInfo(Variant::REAL, "idle_time")));
 
 	// NETWORKING SOCKETS SIGNALS ///////////////
 	ADD_SIGNAL(MethodInfo("network_connection_status_changed", PropertyInfo(Variant::INT, "connect_handle"), PropertyInfo(Variant::DICTIONARY, "connection"), PropertyInfo(Variant::INT, "old_state")));
@@ -11936,6 +14937,10 @@ void Steam::_bind_methods(){
 	// NETWORKING UTILS SIGNALS /////////////////
 	ADD_SIGNAL(MethodInfo("relay_network_status", PropertyInfo(Variant::INT, "available"), PropertyInfo(Variant::INT, "ping_measurement"), PropertyInfo(Variant::INT, "available_config"), PropertyInfo(Variant::INT, "available_relay"), PropertyInfo(Variant::STRING, "debug_message")));
 
+	// NETWORKING CAPTURE SIGNALS ///////////////
+	ADD_SIGNAL(MethodInfo("message_replay_finished", PropertyInfo(Variant::INT, "delivered")));
+	ADD_SIGNAL(MethodInfo("time_sync_updated", PropertyInfo(Variant::INT, "offset"), PropertyInfo(Variant::INT, "rtt")));
+
 	// PARENTAL SETTINGS SIGNALS ////////////////
 	ADD_SIGNAL(MethodInfo("parental_setting_changed"));
 
@@ -11946,6 +14951,7 @@ void Steam::_bind_methods(){
 	ADD_SIGNAL(MethodInfo("change_num_open_slots", PropertyInfo(Variant::INT, "result")));
 	ADD_SIGNAL(MethodInfo("available_beacon_locations_updated"));
 	ADD_SIGNAL(MethodInfo("active_beacons_updated"));
+	ADD_SIGNAL(MethodInfo("beacons_snapshot_changed", PropertyInfo(Variant::DICTIONARY, "changes")));
 
 	// REMOTE PLAY SIGNALS //////////////////////
 	ADD_SIGNAL(MethodInfo("remote_play_session_connected", PropertyInfo(Variant::INT, "session_id")));
@@ -12024,6 +15030,7 @@ void Steam::_bind_methods(){
 	ADD_SIGNAL(MethodInfo("app_resuming_from_suspend"));
 	ADD_SIGNAL(MethodInfo("floating_gamepad_text_input_dismissed"));
 	ADD_SIGNAL(MethodInfo("filter_text_dictionary_changed", PropertyInfo(Variant::INT, "language")));
+	ADD_SIGNAL(MethodInfo("image_texture_loaded", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::INT, "image"), PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "ImageTexture")));
 
 	// VIDEO SIGNALS ////////////////////////////
 	ADD_SIGNAL(MethodInfo("get_opf_settings_result", PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "app_id")));
@@ -12061,6 +15068,19 @@ void Steam::_bind_methods(){
 	BIND_CONSTANT(PERSONA_NAME_MAX_UTF8);												// 128
 	BIND_CONSTANT(PERSONA_NAME_MAX_UTF16);												// 32
 
+	// GAME SEARCH CONSTANTS ////////////////////
+	BIND_CONSTANT(GAME_SEARCH_ROLE_PLAYER);												// 0
+	BIND_CONSTANT(GAME_SEARCH_ROLE_HOST);												// 1
+	BIND_CONSTANT(GAME_SEARCH_STATE_IDLE);												// 0
+	BIND_CONSTANT(GAME_SEARCH_STATE_SEARCHING);											// 1
+	BIND_CONSTANT(GAME_SEARCH_STATE_WAITING_RETRY);										// 2
+	BIND_CONSTANT(GAME_SEARCH_STATE_FOUND);												// 3
+	BIND_CONSTANT(GAME_SEARCH_STATE_ACCEPTED);											// 4
+	BIND_CONSTANT(GAME_SEARCH_STATE_READY);												// 5
+	BIND_CONSTANT(GAME_SEARCH_STATE_ENDED);												// 6
+	BIND_CONSTANT(GAME_SEARCH_STATE_FAILED);											// 7
+	BIND_CONSTANT(GAME_SEARCH_STATE_CANCELLED);											// 8
+
 	// HTML SURFACE CONSTANTS ///////////////////
 	BIND_CONSTANT(INVALID_HTMLBROWSER);													// 0
 
@@ -12094,6 +15114,13 @@ void Steam::_bind_methods(){
 	BIND_CONSTANT(MAX_GAME_SERVER_MAP_NAME);											// 32
 	BIND_CONSTANT(MAX_GAME_SERVER_NAME);												// 64
 	BIND_CONSTANT(MAX_GAME_SERVER_TAGS);												// 128
+	BIND_CONSTANT(SERVER_SORT_PING);													// 0
+	BIND_CONSTANT(SERVER_SORT_PLAYERS);													// 1
+	BIND_CONSTANT(SERVER_SORT_MAP);														// 2
+	BIND_CONSTANT(SERVER_SORT_NAME);													// 3
+	BIND_CONSTANT(SERVER_QUERY_PING);													// 1
+	BIND_CONSTANT(SERVER_QUERY_PLAYERS);												// 2
+	BIND_CONSTANT(SERVER_QUERY_RULES);													// 4
 
 	// MUSIC REMOTE CONSTANTS ///////////////////
 	BIND_CONSTANT(MUSIC_NAME_MAX_LENGTH); 												// 255
@@ -12104,6 +15131,10 @@ void Steam::_bind_methods(){
 	BIND_CONSTANT(NETWORKING_SEND_NO_NAGLE);											// 1
 	BIND_CONSTANT(NETWORKING_SEND_NO_DELAY);											// 4
 	BIND_CONSTANT(NETWORKING_SEND_RELIABLE);											// 8
+	BIND_CONSTANT(SESSION_ACCEPT_NONE);													// 0
+	BIND_CONSTANT(SESSION_ACCEPT_FRIENDS);												// 1
+	BIND_CONSTANT(SESSION_ACCEPT_LOBBY);												// 2
+	BIND_CONSTANT(SESSION_ACCEPT_ALLOWLIST);											// 4
 
 	// REMOTE PLAY CONSTANTS ////////////////////
 	BIND_CONSTANT(DEVICE_FORM_FACTOR_UNKNOWN);											// 0
@@ -13661,6 +16692,17 @@ void Steam::_bind_methods(){
 }
 
 Steam::~Steam(){
+	// Let the image worker finish before Steam shuts down
+	stopImageThread();
+
+	// Finish any message capture so its index is written
+	if(message_capture_file.is_open()){
+		stopMessageCapture();
+	}
+
+	// Cancel server queries while their response objects still exist
+	server_queries.clear();
+
 	// Store stats then shut down ///////////////
 	if(is_init_success){
 		SteamUserStats()->StoreStats();
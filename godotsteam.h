@@ -30,9 +30,25 @@
 #include "core/reference.h"
 #include "core/dictionary.h"
 #include "core/method_bind_ext.gen.inc"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "servers/audio/effects/audio_stream_generator.h"
+
+// Include GodotSteam helpers
+#include "godotsteam_html.h"
+#include "godotsteam_mapped_file.h"
+#include "godotsteam_servers.h"
+#include "godotsteam_voice.h"
 
 // Include some system headers
+#include "deque"
+#include "list"
 #include "map"
+#include "set"
+#include "unordered_map"
+#include "unordered_set"
+#include "vector"
 
 class Steam: public Object {
 	GDCLASS(Steam, Object);
@@ -481,6 +497,11 @@ class Steam: public Object {
 		};
 		
 		static Steam* get_singleton();
+		SteamVoiceMixer* get_voice_mixer(){ return &voice_mixer; }
+		void registerHTMLTexture(uint32 this_handle, SteamHTMLTexture* texture);
+		void unregisterHTMLTexture(uint32 this_handle, SteamHTMLTexture* texture);
+		void registerHTMLRect(uint32 this_handle, SteamHTMLRect* rect);
+		void unregisterHTMLRect(uint32 this_handle, SteamHTMLRect* rect);
 		Steam();
 		~Steam();
 
@@ -541,10 +562,15 @@ class Steam: public Object {
 		void activateGameOverlayToStore(uint32_t app_id = 0);
 		void activateGameOverlayToUser(const String& type, uint64_t steam_id);
 		void activateGameOverlayToWebPage(const String& url);
+		void clearAvatarAtlas();
+		void clearAvatarCache();
 		void clearRichPresence();
 		bool closeClanChatWindowInSteam(uint64_t chat_id);
 		void downloadClanActivityCounts(uint64_t clan_id, int clans_to_request);
 		void enumerateFollowingList(uint32 start_index);
+		void flushRichPresence();
+		Dictionary getAvatarAtlasRegion(uint64_t steam_id = 0, int size = 2);
+		Ref<ImageTexture> getAvatarTexture(uint64_t steam_id = 0, int size = 2);
 		uint64_t getChatMemberByIndex(uint64_t clan_id, int user);
 		Dictionary getClanActivityCounts(uint64_t clan_id);
 		uint64_t getClanByIndex(int clan);
@@ -579,6 +605,9 @@ class Steam: public Object {
 		int getFriendsGroupMembersCount(int16 friend_group);
 		Array getFriendsGroupMembersList(int16 friend_group, int member_count);
 		String getFriendsGroupName(int16 friend_group);
+		Dictionary getFriendsRichPresence(Array steam_ids);
+		Dictionary getFriendsRichPresenceChanges();
+		Dictionary getFriendsSnapshot(int friend_flags = 0x04);
 		int getFriendSteamLevel(uint64_t steam_id);
 		int getLargeFriendAvatar(uint64_t steam_id);
 		int getMediumFriendAvatar(uint64_t steam_id);
@@ -612,11 +641,14 @@ class Steam: public Object {
 		void requestFriendRichPresence(uint64_t friend_id);
 		bool requestUserInformation(uint64_t steam_id, bool require_name_only);
 		bool sendClanChatMessage(uint64_t chat_id, const String& text);
+		void setAvatarAtlasSize(uint32 max_slots);
+		void setAvatarCacheSize(uint32 max_entries);
 		void setInGameVoiceSpeaking(uint64_t steam_id, bool speaking);
 		bool setListenForFriendsMessages(bool intercept);
 		void setPersonaName(const String& name);
 		void setPlayedWith(uint64_t steam_id);
 		bool setRichPresence(const String& key, const String& value);
+		void setRichPresenceFlushInterval(float interval);
 
 		// Game Search //////////////////////////
 		int addGameSearchParams(const String& key, const String& values);
@@ -633,6 +665,10 @@ class Steam: public Object {
 		int cancelRequestPlayersForGame();
 		int submitPlayerResult(uint64_t game_id, uint64_t player_id, PlayerResult player_result);
 		int endGame(uint64_t game_id);
+		bool startGameSearch(Dictionary settings);
+		bool startGameHostSearch(Dictionary settings);
+		void cancelGameSearch(int role);
+		Dictionary getGameSearchStatus(int role);
 
 		// HTML Surface /////////////////////////
 		void addHeader(const String& key, const String& value, uint32 this_handle = 0);
@@ -787,13 +823,14 @@ class Steam: public Object {
 		Array getFavoriteGames();
 		int addFavoriteGame(uint32 ip, uint16 port, uint16 query_port, uint32 flags, uint32 last_played);
 		bool removeFavoriteGame(uint32 app_id, uint32 ip, uint16 port, uint16 query_port, uint32 flags);
-		void requestLobbyList();
+		void requestLobbyList(PoolStringArray prefetch_keys = PoolStringArray());
 		void addRequestLobbyListStringFilter(const String& key_to_match, const String& value_to_match, LobbyComparison comparison_type);
 		void addRequestLobbyListNumericalFilter(const String& key_to_match, int value_to_match, LobbyComparison comparison_type);
 		void addRequestLobbyListNearValueFilter(const String& key_to_match, int value_to_be_close_to);
 		void addRequestLobbyListFilterSlotsAvailable(int slots_available);
 		void addRequestLobbyListDistanceFilter(LobbyDistanceFilter distance_filter);
 		void addRequestLobbyListResultCountFilter(int max_results);
+		Dictionary rankLobbies(Array lobby_ids, Dictionary weights);
 		void createLobby(LobbyType lobby_type, int max_members);
 		void joinLobby(uint64_t steam_lobby_id);
 		void leaveLobby(uint64_t steam_lobby_id);
@@ -803,10 +840,15 @@ class Steam: public Object {
 		String getLobbyData(uint64_t steam_lobby_id, const String& key);
 		bool setLobbyData(uint64_t steam_lobby_id, const String& key, const String& value);
 		Dictionary getAllLobbyData(uint64_t steam_lobby_id);
+		Dictionary getLobbyDataMirror(uint64_t steam_lobby_id);
 		bool deleteLobbyData(uint64_t steam_lobby_id, const String& key);
 		String getLobbyMemberData(uint64_t steam_lobby_id, uint64_t steam_id_user, const String& key);
 		void setLobbyMemberData(uint64_t steam_lobby_id, const String& key, const String& value);
+		void setLobbyMemberDataKeys(PoolStringArray keys);
 		bool sendLobbyChatMsg(uint64_t steam_lobby_id, const String& message_body);
+		bool sendLobbyChatBinary(uint64_t steam_lobby_id, PoolByteArray data);
+		bool queueLobbyChatBinary(uint64_t steam_lobby_id, PoolByteArray data);
+		void flushLobbyChat(uint64_t steam_lobby_id = 0);
 		bool requestLobbyData(uint64_t steam_lobby_id);
 		void setLobbyGameServer(uint64_t steam_lobby_id, const String& server_ip, uint16 server_port, uint64_t steam_id_game_server);
 		Dictionary getLobbyGameServer(uint64_t steam_lobby_id);
@@ -819,22 +861,31 @@ class Steam: public Object {
 
 		// Matchmaking Servers //////////////////
 		void cancelQuery(uint64_t server_list_request = 0);
+		void cancelServerQueries();
 		void cancelServerQuery(int server_query);
 		int getServerCount(uint64_t server_list_request = 0);
 		Dictionary getServerDetails(int server, uint64_t server_list_request = 0);
+		int getServerListCount();
+		Array getServerListPage(int offset, int count);
+		Dictionary getServerQueryStatus();
 		bool isRefreshing(uint64_t server_list_request = 0);
 		int pingServer(const String& ip, uint16 port);
 		int playerDetails(const String& ip, uint16 port);
+		bool queueServerQuery(const String& ip, uint16 port, int kinds = 1, int priority = 0);
 		void refreshQuery(uint64_t server_list_request = 0);
 		void refreshServer(int server, uint64_t server_list_request = 0);
 		void releaseRequest(uint64_t server_list_request = 0);
-		uint64_t requestFavoritesServerList(uint32 app_id, Array filters);
-		uint64_t requestFriendsServerList(uint32 app_id, Array filters);
-		uint64_t requestHistoryServerList(uint32 app_id, Array filters);
-		uint64_t requestInternetServerList(uint32 app_id, Array filters);
+		uint64_t requestFavoritesServerList(uint32 app_id, Variant filters);
+		uint64_t requestFriendsServerList(uint32 app_id, Variant filters);
+		uint64_t requestHistoryServerList(uint32 app_id, Variant filters);
+		uint64_t requestInternetServerList(uint32 app_id, Variant filters);
 		uint64_t requestLANServerList(uint32 app_id);
-		uint64_t requestSpectatorServerList(uint32 app_id, Array filters);
+		uint64_t requestSpectatorServerList(uint32 app_id, Variant filters);
 		int serverRules(const String& ip, uint16 port);
+		void setServerListCache(const String& path);
+		void setServerListFilter(Dictionary filter);
+		void setServerListSort(int field = 0, bool ascending = true);
+		void setServerQueryLimits(int max_in_flight = 8, float timeout = 2.0);
 
 		// Music ////////////////////////////////
 		bool musicIsEnabled();
@@ -893,11 +944,18 @@ class Steam: public Object {
 
 		// Networking Messages //////////////////
 		bool acceptSessionWithUser(const String& identity_reference);
+		void addSessionAllowlist(uint64_t steam_id);
+		void clearSessionAllowlist();
 		bool closeChannelWithUser(const String& identity_reference, int channel);
 		bool closeSessionWithUser(const String& identity_reference);
+		Dictionary getManagedSessions();
 		Dictionary getSessionConnectionInfo(const String& identity_reference, bool get_connection, bool get_status);
 		Array receiveMessagesOnChannel(int channel, int max_messages);
+		Array receiveMessagesOnChannels(const PoolIntArray channels, int max_messages);
+		void removeSessionAllowlist(uint64_t steam_id);
 		int sendMessageToUser(const String& identity_reference, const PoolByteArray data, int flags, int channel);
+		void setSessionAcceptPolicy(int policy, uint64_t lobby_id = 0);
+		void setSessionIdleTimeout(float timeout);
 		
 		// Networking Sockets ///////////////////
 		int acceptConnection(uint32 connection);
@@ -922,6 +980,7 @@ class Steam: public Object {
 		Dictionary getConnectionInfo(uint32 connection_handle);
 		String getConnectionName(uint32 peer);
 		Dictionary getConnectionRealTimeStatus(uint32 connection_handle, int lanes, bool get_status = true);
+		Dictionary getConnectionTable();
 		uint64_t getConnectionUserData(uint32 peer);
 		Dictionary getDetailedConnectionStatus(uint32 connection_handle);
 		Dictionary getFakeIP(int first_port = 0);
@@ -932,6 +991,11 @@ class Steam: public Object {
 		bool getListenSocketAddress(uint32 socket);
 		String getIdentity();
 		Dictionary getRemoteFakeIPForConnection(uint32 connection);
+		Dictionary getTrackedConnection(uint32 connection);
+		String getTrackedConnectionIdentity(uint32 connection);
+		uint32 getTrackedConnectionPollGroup(uint32 connection);
+		NetworkingConnectionState getTrackedConnectionState(uint32 connection);
+		uint64_t getTrackedConnectionUserData(uint32 connection);
 		NetworkingAvailability initAuthentication();
 		Array receiveMessagesOnConnection(uint32 connection, int max_messages);
 		Array receiveMessagesOnPollGroup(uint32 poll_group, int max_messages);
@@ -943,6 +1007,7 @@ class Steam: public Object {
 		Dictionary setCertificate(const PoolByteArray& certificate);		
 		bool setConnectionPollGroup(uint32 connection_handle, uint32 poll_group);
 		void setConnectionName(uint32 peer, const String& name);
+		bool setConnectionUserData(uint32 peer, uint64_t user_data);
 
 		// Networking Types /////////////////////
 		bool addIdentity(const String& reference_name);
@@ -1007,6 +1072,30 @@ class Steam: public Object {
 		bool setGlobalConfigValueInt32(NetworkingConfigValue config, int32 value);
 		bool setGlobalConfigValueString(NetworkingConfigValue config, const String& value);
 
+		// Networking Capture ///////////////////
+		Dictionary getMessageReplayStatus();
+		bool isCapturingMessages();
+		bool isReplayingMessages();
+		bool startMessageCapture(const String& path, uint32 initial_size = 16777216);
+		bool startMessageReplay(const String& path, float speed = 1.0);
+		Dictionary stopMessageCapture();
+		void stopMessageReplay();
+
+		// Networking Time Sync /////////////////
+		uint64_t getServerTime();
+		Dictionary getTimeSyncStatus();
+		bool isTimeSynced();
+		bool startTimeSync(uint64_t host_steam_id, int channel = 255, float interval = 1.0);
+		void stopTimeSync();
+
+		// Networking Telemetry /////////////////
+		void clearConnectionTelemetry();
+		Dictionary getConnectionTelemetry(uint32 connection);
+		Dictionary getConnectionTelemetrySummary();
+		bool isConnectionTelemetryActive();
+		bool startConnectionTelemetry(float interval = 0.1, uint32 history_size = 600);
+		void stopConnectionTelemetry();
+
 		// Parental Settings ////////////////////
 		bool isParentalLockEnabled();
 		bool isParentalLockLocked();
@@ -1024,6 +1113,7 @@ class Steam: public Object {
 		uint64_t getBeaconByIndex(uint32 index);
 		Dictionary getBeaconDetails(uint64_t beacon_id);
 		String getBeaconLocationData(uint64_t location_id, SteamPartyBeaconLocationType location_type, SteamPartyBeaconLocationData location_data);
+		Dictionary getBeaconsSnapshot();
 		uint32 getNumActiveBeacons();
 		void joinParty(uint64_t beacon_id);
 		void onReservationCompleted(uint64_t beacon_id, uint64_t steam_id);
@@ -1270,6 +1360,7 @@ class Steam: public Object {
 		bool isSteamRunningInVR();
 		bool isVRHeadsetStreamingEnabled();
 		bool overlayNeedsPresent();
+		uint32 requestImageTexture(int image, bool mipmaps = false);
 		void setOverlayNotificationInset(int horizontal, int vertical);
 		void setOverlayNotificationPosition(int pos);
 		void setVRHeadsetStreamingEnabled(bool enabled);
@@ -1286,6 +1377,18 @@ class Steam: public Object {
 		void getVideoURL(uint32_t app_id);
 		Dictionary isBroadcasting();
 
+		// Voice ////////////////////////////////
+		void addVoicePeer(uint64_t steam_id);
+		void clearVoicePeers();
+		uint32 getVoicePipelineSampleRate();
+		Dictionary getVoiceSpeakerStatus(uint64_t steam_id);
+		bool isVoicePipelineActive();
+		void removeVoicePeer(uint64_t steam_id);
+		void setVoiceJitterBuffer(float min_delay = 0.04, float max_delay = 0.3);
+		void setVoicePlayback(uint64_t steam_id, const Ref<AudioStreamGeneratorPlayback>& playback);
+		bool startVoicePipeline(int channel = 254, uint32 sample_rate = 0);
+		void stopVoicePipeline();
+
 	protected:
 		static void _bind_methods();
 		static Steam* singleton;
@@ -1299,9 +1402,72 @@ class Steam: public Object {
 		
 		// Friends
 		CSteamID clan_activity;
+		struct AvatarCacheEntry {
+			uint64_t steam_id;
+			int size;
+			Ref<ImageTexture> texture;
+		};
+		std::list<AvatarCacheEntry> avatar_cache;
+		std::map<std::pair<uint64_t, int>, std::list<AvatarCacheEntry>::iterator> avatar_cache_index;
+		std::set<std::pair<uint64_t, int>> avatar_cache_pending;
+		uint32 avatar_cache_size = 256;
+		struct AvatarAtlasPage {
+			int cell_size;
+			std::vector<bool> used;
+			Ref<ImageTexture> texture;
+		};
+		struct AvatarAtlasSlot {
+			int page;
+			int cell;
+			Dictionary region;
+			std::list<std::pair<uint64_t, int>>::iterator lru;
+		};
+		std::vector<AvatarAtlasPage> avatar_atlas_pages;
+		std::map<std::pair<uint64_t, int>, AvatarAtlasSlot> avatar_atlas_slots;
+		std::list<std::pair<uint64_t, int>> avatar_atlas_lru;
+		std::set<std::pair<uint64_t, int>> avatar_atlas_pending;
+		uint32 avatar_atlas_size = 900; // One full page of small avatars
+		int getAvatarHandle(uint64_t steam_id, int size);
+		Ref<Image> getAvatarImage(int handle);
+		Ref<ImageTexture> fetchAvatar(uint64_t steam_id, int size);
+		Ref<ImageTexture> cacheAvatar(uint64_t steam_id, int size, const Ref<Image>& image);
+		void trimAvatarCache();
+		void trimAvatarAtlas(uint32 max_slots);
+		Dictionary fetchAtlasAvatar(uint64_t steam_id, int size);
+		Dictionary drawAtlasAvatar(uint64_t steam_id, int size, const Ref<Image>& image);
+		void resolvePendingAvatar(uint64_t steam_id, int size, const Ref<Image>& image = Ref<Image>());
+		struct FriendSnapshotEntry {
+			uint64_t steam_id;
+			String name;
+			int state;
+			uint32 game_id;
+			int level;
+			int relationship;
+		};
+		bool friends_snapshot_active = false;
+		int friends_snapshot_flags = 0x04;
+		std::vector<FriendSnapshotEntry> friends_snapshot;
+		std::unordered_map<uint64_t, uint32_t> friends_snapshot_index;
+		std::map<uint64_t, int> friends_snapshot_changes;
+		std::set<uint64_t> friends_snapshot_removed;
+		void readFriendSnapshotEntry(FriendSnapshotEntry& entry, int flags);
+		void trackFriendChange(uint64_t steam_id, int flags);
+		Dictionary packFriendsSnapshot(const std::vector<uint32_t>& indices);
+		void updateFriendsSnapshot();
+		std::unordered_map<uint64_t, std::map<String, String>> rich_presence_mirror;
+		std::map<uint64_t, std::set<String>> rich_presence_changes;
+		std::map<String, String>& mirrorFriendRichPresence(uint64_t steam_id);
+		static void diffKeyValues(const std::map<String, String>& old_values, const std::map<String, String>& new_values, std::set<String>& changed);
+		std::map<String, String> rich_presence_written;
+		std::map<String, String> rich_presence_pending;
+		uint64_t rich_presence_interval = 0;
+		uint64_t rich_presence_last_flush = 0;
+		void updateRichPresence();
 
 		// HTML Surface
 		uint32 browser_handle;
+		std::map<uint32, SteamHTMLTexture*> html_textures;
+		std::map<uint32, SteamHTMLRect*> html_rects;
 
 		// HTTP
 		uint32 cookie_handle;
@@ -1317,16 +1483,48 @@ class Steam: public Object {
 		Array leaderboard_entries_array;
 		int leaderboard_details_max = 0;
 
+		// Matchmaking
+		std::vector<CharString> lobby_list_prefetch_keys;
+		struct LobbyRank {
+			uint64_t lobby_id;
+			float score;
+			int ping;
+			bool operator<(const LobbyRank& other) const { return score > other.score; }
+		};
+		struct LobbyMirror {
+			std::map<String, String> data;
+			std::map<uint64_t, std::map<String, String>> members;
+		};
+		std::unordered_map<uint64_t, LobbyMirror> lobby_mirrors;
+		std::vector<CharString> lobby_member_data_keys;
+		void mirrorLobbyData(uint64_t lobby_id, std::set<String>& changed);
+		void mirrorLobbyMemberData(uint64_t lobby_id, uint64_t member_id, std::set<String>& changed);
+		std::map<uint64_t, std::vector<uint8_t>> lobby_chat_batches;
+		bool sendLobbyChatFrame(uint64_t lobby_id, uint8_t kind, const uint8_t* data, uint32_t size);
+
 		// Matchmaking Server
 		HServerListRequest server_list_request;
 		HServerQuery server_query = HSERVERQUERY_INVALID;
 		ISteamMatchmakingServerListResponse* server_list_response;
-		ISteamMatchmakingPingResponse *ping_response;
-		ISteamMatchmakingPlayersResponse *player_response;
-		ISteamMatchmakingRulesResponse *rules_response;
+		SteamServerList server_list;
+		SteamServerQueries server_queries;
+		String server_list_cache;
+		Ref<SteamServerFilter> getServerFilter(const Variant& filters);
+		uint32_t resolveServerAddress(const String& ip);
+		void updateServerList();
+		void updateServerQueries();
 
 		// Networking Messages
 //		std::map<int, SteamNetworkingMessage_t> network_messages;
+		int session_accept_policy = 0;
+		uint64_t session_accept_lobby = 0;
+		uint64_t session_idle_timeout = 0;
+		uint64_t session_next_check = 0;
+		std::unordered_set<uint64_t> session_allowlist;
+		std::unordered_map<uint64_t, uint64_t> managed_sessions;
+		bool isSessionAllowed(uint64_t steam_id);
+		void touchSession(uint64_t steam_id);
+		void updateSessions();
 
 		// Networking Sockets
 		uint32 network_connection;
@@ -1340,9 +1538,103 @@ class Steam: public Object {
 //		SteamDatagramRelayAuthTicket relay_auth_ticket;
 		std::map<String, SteamNetworkingIdentity> networking_identities;
 		std::map<String, SteamNetworkingIPAddr> ip_addresses;
+		struct TrackedConnection {
+			int state;
+			int end_reason;
+			uint32 listen_socket;
+			uint32 poll_group;
+			uint64_t steam_id;
+			uint64_t user_data;
+			String identity;
+		};
+		std::unordered_map<uint32, TrackedConnection> tracked_connections;
+		std::unordered_map<uint32, uint32> untracked_poll_groups;
+
+		// Networking Capture
+		SteamMappedFile message_capture_file;
+		uint64_t message_capture_end = 0;
+		std::vector<uint32_t> message_capture_index;
+		SteamMappedFile message_replay_file;
+		std::vector<uint64_t> message_replay_offsets;
+		std::vector<uint64_t> message_replay_pending;
+		size_t message_replay_cursor = 0;
+		uint64_t message_replay_first_time = 0;
+		uint64_t message_replay_start = 0;
+		uint64_t message_replay_delivered = 0;
+		uint64_t message_replay_idle_since = 0;
+		float message_replay_speed = 1.0;
+		void captureMessage(uint8 direction, uint8 api, uint32 connection, uint32 poll_group, int channel, int flags, int64 message_number, uint64_t user_data, uint64_t time, const SteamNetworkingIdentity* identity, const void* payload, uint32 size);
+		void captureReceivedMessage(uint8 api, uint32 poll_group, const SteamNetworkingMessage_t* message);
+		Array replayMessages(uint8 api, int64_t connection, int64_t poll_group, int channel, int max_messages);
+
+		// Networking Time Sync
+		struct TimeSyncPacket {
+			uint32_t type;
+			uint32_t sequence;
+			uint64_t client_send;
+			uint64_t server_receive;
+			uint64_t server_send;
+		};
+		struct TimeSyncSample {
+			uint64_t local_time;
+			int64_t offset;
+			int64_t rtt;
+		};
+		bool time_sync_active = false;
+		uint64_t time_sync_host = 0;
+		int time_sync_channel = 255;
+		uint64_t time_sync_interval = 1000000;
+		uint64_t time_sync_next_ping = 0;
+		uint32 time_sync_sequence = 0;
+		std::vector<TimeSyncSample> time_sync_samples;
+		double time_sync_offset = 0.0;
+		double time_sync_drift = 0.0;
+		uint64_t time_sync_reference = 0;
+		int64_t time_sync_rtt = 0;
+		void updateTimeSync();
+		void addTimeSyncSample(const TimeSyncPacket& packet, uint64_t client_receive);
+
+		// Networking Telemetry
+		struct TelemetrySample {
+			uint64_t time;
+			int ping;
+			float local_quality;
+			float remote_quality;
+			float bytes_in_per_second;
+			float bytes_out_per_second;
+			int pending;
+			int queue_time;
+		};
+		struct ConnectionTelemetry {
+			std::vector<TelemetrySample> samples;
+			uint32 head = 0;
+			uint32 count = 0;
+			uint64_t last_time = 0;
+			std::vector<uint32_t> ping_histogram;
+			std::vector<uint32_t> queue_time_histogram;
+		};
+		bool telemetry_active = false;
+		uint64_t telemetry_interval = 100000;
+		uint64_t telemetry_next_sample = 0;
+		uint32 telemetry_history_size = 600;
+		std::unordered_map<uint32, ConnectionTelemetry> connection_telemetry;
+		void updateConnectionTelemetry();
+		int getTelemetryBucket(int value);
+		int getTelemetryPercentile(const std::vector<uint32_t>& histogram, uint32 count, float percentile);
 
 		// Parties
 		uint64 party_beacon_id;
+		struct BeaconSnapshotEntry {
+			uint64_t beacon_id;
+			uint64_t owner_id;
+			int type;
+			uint64_t location_id;
+			String metadata;
+		};
+		bool beacons_snapshot_active = false;
+		std::vector<BeaconSnapshotEntry> beacons_snapshot;
+		void readBeaconsSnapshot(std::vector<BeaconSnapshotEntry>& beacons, const std::vector<BeaconSnapshotEntry>& previous, const std::unordered_map<uint64_t, uint32_t>& previous_index);
+		Dictionary packBeaconsSnapshot(const std::vector<uint32_t>& indices);
 
 		// Remote Play
 		uint32 session_id;
@@ -1357,10 +1649,110 @@ class Steam: public Object {
 
 		// Utils
 		uint64_t api_handle = 0;
+		struct ImageRequest {
+			uint32 id;
+			int handle;
+			bool mipmaps;
+			Ref<Image> image;
+		};
+		Thread image_thread;
+		Mutex image_mutex;
+		Semaphore image_semaphore;
+		bool image_thread_exit = false;
+		uint32 image_request_id = 0;
+		int image_requests_outstanding = 0;
+		std::deque<ImageRequest> image_requests;
+		std::vector<ImageRequest> image_results;
+		static void image_thread_function(void* userdata);
+		void deliverImageTextures();
+		void stopImageThread();
+
+		// Voice
+		struct VoiceSpeaker {
+			Ref<AudioStreamGeneratorPlayback> playback;
+			uint32_t last_sequence = 0;
+			uint64_t last_heard = 0;
+		};
+		bool voice_active = false;
+		int voice_channel = 254;
+		uint32 voice_sample_rate = 0;
+		uint32_t voice_sequence = 0;
+		std::vector<uint8_t> voice_capture_buffer;
+		std::vector<uint8_t> voice_decompress_buffer;
+		PoolVector2Array voice_frames;
+		std::unordered_set<uint64_t> voice_peers;
+		std::unordered_map<uint64_t, VoiceSpeaker> voice_speakers;
+		uint64_t voice_next_expiry = 0;
+		SteamVoiceMixer voice_mixer;
+		float voice_min_delay = 0.04;
+		float voice_max_delay = 0.3;
+		void updateVoice();
+		void expireVoiceSpeakers(uint64_t now);
+		uint32 decompressVoicePacket(const uint8_t* voice, uint32 voice_size);
+		void pushVoiceFrames(const Ref<AudioStreamGeneratorPlayback>& playback, const int16_t* samples, int count);
+
+		// Game Search
+		struct GameSearchPlayer {
+			int accept_state;
+			int team;
+			uint64_t lobby_id;
+		};
+		struct GameSearchRun {
+			int state = 0;
+			Dictionary settings;
+			uint32_t attempt = 0;
+			uint64_t retry_at = 0;
+			uint64_t accept_deadline = 0;
+			uint64_t search_id = 0;
+			uint64_t game_id = 0;
+			uint64_t host_id = 0;
+			std::map<uint64_t, GameSearchPlayer> players;
+			std::set<uint64_t> ended_searches;
+		};
+		GameSearchRun game_search_runs[2];
+		bool game_search_timed = false;
+		bool launchGameSearch(int role);
+		void retryGameSearch(int role, const String& reason);
+		void endGameSearch(int role);
+		bool isCurrentGameSearch(int role, uint64_t search_id);
+		void setGameSearchState(int role, int state, Dictionary details = Dictionary());
+		Dictionary gameSearchDetails(int role);
+		void updateGameSearch();
 
 		// Run the Steamworks API callbacks /////
 		void run_callbacks(){
 			SteamAPI_RunCallbacks();
+			if(time_sync_active){
+				updateTimeSync();
+			}
+			if(telemetry_active){
+				updateConnectionTelemetry();
+			}
+			if(session_idle_timeout > 0){
+				updateSessions();
+			}
+			if(voice_active){
+				updateVoice();
+			}
+			if(image_requests_outstanding > 0){
+				deliverImageTextures();
+			}
+			if(game_search_timed){
+				updateGameSearch();
+			}
+			if(!friends_snapshot_changes.empty() || !friends_snapshot_removed.empty()){
+				updateFriendsSnapshot();
+			}
+			if(!rich_presence_pending.empty()){
+				updateRichPresence();
+			}
+			if(!lobby_chat_batches.empty()){
+				flushLobbyChat();
+			}
+			updateServerList();
+			if(server_queries.is_active()){
+				updateServerQueries();
+			}
 		}
 
 
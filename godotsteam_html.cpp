@@ -0,0 +1,456 @@
+/////////////////////////////////////////////////
+///// HEADER INCLUDES
+/////////////////////////////////////////////////
+//
+// Include the HTML header
+#include "godotsteam_html.h"
+
+// Include Godot headers
+#include "core/engine.h"
+#include "servers/visual_server.h"
+
+// Include GodotSteam header
+#include "godotsteam.h"
+
+// Include the SIMD headers
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HTML_SWIZZLE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HTML_SWIZZLE_NEON
+#include <arm_neon.h>
+#endif
+
+
+/////////////////////////////////////////////////
+///// DEFINING CONSTANTS
+/////////////////////////////////////////////////
+//
+// Define HTML Rect constants
+#define HTML_WHEEL_DELTA 100
+
+
+/////////////////////////////////////////////////
+///// SWIZZLE
+/////////////////////////////////////////////////
+//
+// Copy one row of BGRA pixels as RGBA by swapping the blue and red bytes.
+static void swizzle_bgra_row(const uint8_t* source, uint8_t* destination, uint32_t pixels){
+	uint32_t i = 0;
+#if defined(HTML_SWIZZLE_SSE2)
+	// Four pixels at a time: keep green and alpha, move red down and blue up
+	const __m128i green_alpha = _mm_set1_epi32(0xFF00FF00);
+	const __m128i low_byte = _mm_set1_epi32(0x000000FF);
+	for(; i + 4 <= pixels; i += 4){
+		__m128i bgra = _mm_loadu_si128((const __m128i*)(source + i * 4));
+		__m128i red = _mm_and_si128(_mm_srli_epi32(bgra, 16), low_byte);
+		__m128i blue = _mm_slli_epi32(_mm_and_si128(bgra, low_byte), 16);
+		__m128i rgba = _mm_or_si128(_mm_and_si128(bgra, green_alpha), _mm_or_si128(red, blue));
+		_mm_storeu_si128((__m128i*)(destination + i * 4), rgba);
+	}
+#elif defined(HTML_SWIZZLE_NEON)
+	// Sixteen pixels at a time using de-interleaving loads
+	for(; i + 16 <= pixels; i += 16){
+		uint8x16x4_t bgra = vld4q_u8(source + i * 4);
+		uint8x16_t blue = bgra.val[0];
+		bgra.val[0] = bgra.val[2];
+		bgra.val[2] = blue;
+		vst4q_u8(destination + i * 4, bgra);
+	}
+#endif
+	for(; i < pixels; i++){
+		destination[i * 4 + 0] = source[i * 4 + 2];
+		destination[i * 4 + 1] = source[i * 4 + 1];
+		destination[i * 4 + 2] = source[i * 4 + 0];
+		destination[i * 4 + 3] = source[i * 4 + 3];
+	}
+}
+
+
+/////////////////////////////////////////////////
+///// HTML TEXTURE
+/////////////////////////////////////////////////
+//
+SteamHTMLTexture::SteamHTMLTexture(){
+	browser_handle = 0;
+	surface_wide = 0;
+	surface_tall = 0;
+}
+
+SteamHTMLTexture::~SteamHTMLTexture(){
+	if(browser_handle != 0 && Steam::get_singleton() != NULL){
+		Steam::get_singleton()->unregisterHTMLTexture(browser_handle, this);
+	}
+}
+
+// Set which browser this texture shows; it starts updating on the browser's next paint.
+void SteamHTMLTexture::set_browser_handle(uint32_t new_browser_handle){
+	if(new_browser_handle == browser_handle){
+		return;
+	}
+	Steam* steam = Steam::get_singleton();
+	if(steam != NULL && browser_handle != 0){
+		steam->unregisterHTMLTexture(browser_handle, this);
+	}
+	browser_handle = new_browser_handle;
+	surface_wide = 0;
+	surface_tall = 0;
+	if(steam != NULL && browser_handle != 0){
+		steam->registerHTMLTexture(browser_handle, this);
+	}
+}
+
+uint32_t SteamHTMLTexture::get_browser_handle() const {
+	return browser_handle;
+}
+
+// Copy the dirty rectangle of the browser surface into the texture. The whole surface is uploaded when its size changes, otherwise only the dirty rectangle.
+void SteamHTMLTexture::paint(const uint8_t* bgra, uint32_t wide, uint32_t tall, uint32_t update_x, uint32_t update_y, uint32_t update_wide, uint32_t update_tall){
+	if(bgra == NULL || wide == 0 || tall == 0){
+		return;
+	}
+	bool resized = (wide != surface_wide || tall != surface_tall);
+	if(resized){
+		update_x = 0;
+		update_y = 0;
+		update_wide = wide;
+		update_tall = tall;
+	}
+	// Keep the dirty rectangle inside the surface
+	if(update_x >= wide || update_y >= tall){
+		return;
+	}
+	update_wide = MIN(update_wide, wide - update_x);
+	update_tall = MIN(update_tall, tall - update_y);
+	if(update_wide == 0 || update_tall == 0){
+		return;
+	}
+	pixels.resize(update_wide * update_tall * 4);
+	{
+		PoolByteArray::Write pixels_write = pixels.write();
+		for(uint32_t row = 0; row < update_tall; row++){
+			const uint8_t* source = bgra + ((update_y + row) * wide + update_x) * 4;
+			swizzle_bgra_row(source, pixels_write.ptr() + row * update_wide * 4, update_wide);
+		}
+	}
+	Ref<Image> image;
+	image.instance();
+	image->create(update_wide, update_tall, false, Image::FORMAT_RGBA8, pixels);
+	if(resized){
+		create_from_image(image, Texture::FLAG_FILTER);
+		surface_wide = wide;
+		surface_tall = tall;
+	}
+	else{
+		VisualServer::get_singleton()->texture_set_data_partial(get_rid(), image, 0, 0, update_wide, update_tall, update_x, update_y, 0);
+	}
+}
+
+void SteamHTMLTexture::_bind_methods(){
+	ClassDB::bind_method(D_METHOD("set_browser_handle", "browser_handle"), &SteamHTMLTexture::set_browser_handle);
+	ClassDB::bind_method(D_METHOD("get_browser_handle"), &SteamHTMLTexture::get_browser_handle);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "browser_handle"), "set_browser_handle", "get_browser_handle");
+}
+
+
+/////////////////////////////////////////////////
+///// HTML RECT
+/////////////////////////////////////////////////
+//
+SteamHTMLRect::SteamHTMLRect(){
+	allow_navigation = true;
+	navigation_allowed = true;
+	browser_handle = 0;
+	texture.instance();
+	texture->connect("changed", this, "_texture_changed");
+	set_focus_mode(FOCUS_ALL);
+}
+
+// Set the page to show; it is loaded as soon as the browser is ready.
+void SteamHTMLRect::set_url(const String& new_url){
+	url = new_url;
+	if(browser_handle != 0 && !url.empty() && SteamHTMLSurface() != NULL){
+		SteamHTMLSurface()->LoadURL(browser_handle, url.utf8().get_data(), NULL);
+	}
+}
+
+String SteamHTMLRect::get_url() const {
+	return url;
+}
+
+// Set the user agent and CSS used when the browser is created; changing them recreates an existing browser.
+void SteamHTMLRect::set_user_agent(const String& new_user_agent){
+	user_agent = new_user_agent;
+	if(browser_handle != 0){
+		remove_browser();
+		create_browser();
+	}
+}
+
+String SteamHTMLRect::get_user_agent() const {
+	return user_agent;
+}
+
+void SteamHTMLRect::set_user_css(const String& new_user_css){
+	user_css = new_user_css;
+	if(browser_handle != 0){
+		remove_browser();
+		create_browser();
+	}
+}
+
+String SteamHTMLRect::get_user_css() const {
+	return user_css;
+}
+
+// Set whether the browser may navigate unless a navigation_requested handler says otherwise.
+void SteamHTMLRect::set_allow_navigation(bool new_allow_navigation){
+	allow_navigation = new_allow_navigation;
+}
+
+bool SteamHTMLRect::get_allow_navigation() const {
+	return allow_navigation;
+}
+
+// Allow or refuse the navigation being reported by navigation_requested; has no effect outside that signal.
+void SteamHTMLRect::set_navigation_allowed(bool allowed){
+	navigation_allowed = allowed;
+}
+
+uint32_t SteamHTMLRect::get_browser_handle() const {
+	return browser_handle;
+}
+
+Ref<SteamHTMLTexture> SteamHTMLRect::get_texture() const {
+	return texture;
+}
+
+void SteamHTMLRect::_notification(int what){
+	switch(what){
+		case NOTIFICATION_ENTER_TREE:{
+			if(!Engine::get_singleton()->is_editor_hint()){
+				create_browser();
+			}
+			break;
+		}
+		case NOTIFICATION_EXIT_TREE:{
+			remove_browser();
+			break;
+		}
+		case NOTIFICATION_RESIZED:{
+			if(browser_handle != 0 && SteamHTMLSurface() != NULL){
+				SteamHTMLSurface()->SetSize(browser_handle, MAX((int)get_size().x, 1), MAX((int)get_size().y, 1));
+			}
+			break;
+		}
+		case NOTIFICATION_FOCUS_ENTER:
+		case NOTIFICATION_FOCUS_EXIT:{
+			if(browser_handle != 0 && SteamHTMLSurface() != NULL){
+				SteamHTMLSurface()->SetKeyFocus(browser_handle, what == NOTIFICATION_FOCUS_ENTER);
+			}
+			break;
+		}
+		case NOTIFICATION_DRAW:{
+			if(texture->get_width() > 0){
+				draw_texture_rect(texture, Rect2(Point2(), texture->get_size()), false);
+			}
+			break;
+		}
+	}
+}
+
+// Forward mouse and keyboard events to the browser.
+void SteamHTMLRect::_gui_input(const Ref<InputEvent>& event){
+	if(browser_handle == 0 || SteamHTMLSurface() == NULL){
+		return;
+	}
+	Ref<InputEventMouseMotion> motion = event;
+	if(motion.is_valid()){
+		SteamHTMLSurface()->MouseMove(browser_handle, (int)motion->get_position().x, (int)motion->get_position().y);
+		accept_event();
+		return;
+	}
+	Ref<InputEventMouseButton> button = event;
+	if(button.is_valid()){
+		if(button->is_pressed() && (button->get_button_index() == BUTTON_WHEEL_UP || button->get_button_index() == BUTTON_WHEEL_DOWN)){
+			int32 delta = (int32)(HTML_WHEEL_DELTA * MAX(button->get_factor(), 1.0f));
+			SteamHTMLSurface()->MouseWheel(browser_handle, (button->get_button_index() == BUTTON_WHEEL_UP) ? delta : -delta);
+			accept_event();
+			return;
+		}
+		ISteamHTMLSurface::EHTMLMouseButton html_button;
+		switch(button->get_button_index()){
+			case BUTTON_LEFT: html_button = ISteamHTMLSurface::eHTMLMouseButton_Left; break;
+			case BUTTON_RIGHT: html_button = ISteamHTMLSurface::eHTMLMouseButton_Right; break;
+			case BUTTON_MIDDLE: html_button = ISteamHTMLSurface::eHTMLMouseButton_Middle; break;
+			default: return;
+		}
+		SteamHTMLSurface()->MouseMove(browser_handle, (int)button->get_position().x, (int)button->get_position().y);
+		if(button->is_pressed()){
+			grab_focus();
+			if(button->is_doubleclick()){
+				SteamHTMLSurface()->MouseDoubleClick(browser_handle, html_button);
+			}
+			else{
+				SteamHTMLSurface()->MouseDown(browser_handle, html_button);
+			}
+		}
+		else{
+			SteamHTMLSurface()->MouseUp(browser_handle, html_button);
+		}
+		accept_event();
+		return;
+	}
+	Ref<InputEventKey> key = event;
+	if(key.is_valid()){
+		ISteamHTMLSurface::EHTMLKeyModifiers modifiers = (ISteamHTMLSurface::EHTMLKeyModifiers)get_key_modifiers(key);
+		uint32_t native_key_code = get_native_key_code(key->get_scancode());
+		if(key->is_pressed()){
+			if(native_key_code != 0){
+				SteamHTMLSurface()->KeyDown(browser_handle, native_key_code, modifiers);
+			}
+			if(key->get_unicode() != 0){
+				SteamHTMLSurface()->KeyChar(browser_handle, key->get_unicode(), modifiers);
+			}
+		}
+		else if(native_key_code != 0){
+			SteamHTMLSurface()->KeyUp(browser_handle, native_key_code, modifiers);
+		}
+		accept_event();
+	}
+}
+
+// Ask Steam for a browser; the handle arrives in browser_ready.
+void SteamHTMLRect::create_browser(){
+	if(SteamHTMLSurface() == NULL || browser_handle != 0 || callResultBrowserReady.IsActive()){
+		return;
+	}
+	SteamAPICall_t api_call = SteamHTMLSurface()->CreateBrowser(user_agent.utf8().get_data(), user_css.utf8().get_data());
+	callResultBrowserReady.Set(api_call, this, &SteamHTMLRect::browser_ready);
+}
+
+void SteamHTMLRect::remove_browser(){
+	callResultBrowserReady.Cancel();
+	if(browser_handle != 0 && Steam::get_singleton() != NULL){
+		Steam::get_singleton()->unregisterHTMLRect(browser_handle, this);
+	}
+	if(browser_handle != 0 && SteamHTMLSurface() != NULL){
+		SteamHTMLSurface()->RemoveBrowser(browser_handle);
+	}
+	browser_handle = 0;
+	texture->set_browser_handle(0);
+}
+
+void SteamHTMLRect::browser_ready(HTML_BrowserReady_t* call_data, bool io_failure){
+	if(io_failure){
+		printf("[Steam] Failed to create browser for SteamHTMLRect.\n");
+		return;
+	}
+	browser_handle = call_data->unBrowserHandle;
+	texture->set_browser_handle(browser_handle);
+	if(Steam::get_singleton() != NULL){
+		Steam::get_singleton()->registerHTMLRect(browser_handle, this);
+	}
+	SteamHTMLSurface()->SetSize(browser_handle, MAX((int)get_size().x, 1), MAX((int)get_size().y, 1));
+	SteamHTMLSurface()->SetKeyFocus(browser_handle, has_focus());
+	if(!url.empty()){
+		SteamHTMLSurface()->LoadURL(browser_handle, url.utf8().get_data(), NULL);
+	}
+	emit_signal("browser_ready", browser_handle);
+}
+
+// Answer the browser's navigation with allow_navigation, or whatever a navigation_requested handler chose.
+void SteamHTMLRect::start_request(const String& request_url, const String& target, const String& post_data, bool redirect){
+	if(browser_handle == 0 || SteamHTMLSurface() == NULL){
+		return;
+	}
+	navigation_allowed = allow_navigation;
+	emit_signal("navigation_requested", request_url, target, post_data, redirect);
+	SteamHTMLSurface()->AllowStartRequest(browser_handle, navigation_allowed);
+}
+
+// Dismiss alerts and decline confirmations straight away so the page never waits on them.
+void SteamHTMLRect::js_dialog(bool confirm){
+	if(browser_handle != 0 && SteamHTMLSurface() != NULL){
+		SteamHTMLSurface()->JSDialogResponse(browser_handle, !confirm);
+	}
+}
+
+// Cancel file pickers; the control has no file dialog of its own.
+void SteamHTMLRect::file_open_dialog(){
+	if(browser_handle != 0 && SteamHTMLSurface() != NULL){
+		SteamHTMLSurface()->FileLoadDialogResponse(browser_handle, NULL);
+	}
+}
+
+void SteamHTMLRect::_texture_changed(){
+	update();
+}
+
+// Map Godot key codes to the Windows virtual key codes the HTML surface expects.
+uint32_t SteamHTMLRect::get_native_key_code(uint32_t scancode){
+	if((scancode >= KEY_A && scancode <= KEY_Z) || (scancode >= KEY_0 && scancode <= KEY_9)){
+		return scancode;
+	}
+	if(scancode >= KEY_F1 && scancode <= KEY_F12){
+		return 0x70 + (scancode - KEY_F1);
+	}
+	switch(scancode){
+		case KEY_BACKSPACE: return 0x08;
+		case KEY_TAB: return 0x09;
+		case KEY_ENTER: return 0x0D;
+		case KEY_KP_ENTER: return 0x0D;
+		case KEY_SHIFT: return 0x10;
+		case KEY_CONTROL: return 0x11;
+		case KEY_ALT: return 0x12;
+		case KEY_ESCAPE: return 0x1B;
+		case KEY_SPACE: return 0x20;
+		case KEY_PAGEUP: return 0x21;
+		case KEY_PAGEDOWN: return 0x22;
+		case KEY_END: return 0x23;
+		case KEY_HOME: return 0x24;
+		case KEY_LEFT: return 0x25;
+		case KEY_UP: return 0x26;
+		case KEY_RIGHT: return 0x27;
+		case KEY_DOWN: return 0x28;
+		case KEY_INSERT: return 0x2D;
+		case KEY_DELETE: return 0x2E;
+	}
+	return 0;
+}
+
+uint32_t SteamHTMLRect::get_key_modifiers(const Ref<InputEventWithModifiers>& event){
+	uint32_t modifiers = ISteamHTMLSurface::k_eHTMLKeyModifier_None;
+	if(event->get_alt()){
+		modifiers |= ISteamHTMLSurface::k_eHTMLKeyModifier_AltDown;
+	}
+	if(event->get_control() || event->get_command()){
+		modifiers |= ISteamHTMLSurface::k_eHTMLKeyModifier_CtrlDown;
+	}
+	if(event->get_shift()){
+		modifiers |= ISteamHTMLSurface::k_eHTMLKeyModifier_ShiftDown;
+	}
+	return modifiers;
+}
+
+void SteamHTMLRect::_bind_methods(){
+	ClassDB::bind_method(D_METHOD("_gui_input", "event"), &SteamHTMLRect::_gui_input);
+	ClassDB::bind_method(D_METHOD("_texture_changed"), &SteamHTMLRect::_texture_changed);
+	ClassDB::bind_method(D_METHOD("set_url", "url"), &SteamHTMLRect::set_url);
+	ClassDB::bind_method(D_METHOD("get_url"), &SteamHTMLRect::get_url);
+	ClassDB::bind_method(D_METHOD("set_user_agent", "user_agent"), &SteamHTMLRect::set_user_agent);
+	ClassDB::bind_method(D_METHOD("get_user_agent"), &SteamHTMLRect::get_user_agent);
+	ClassDB::bind_method(D_METHOD("set_user_css", "user_css"), &SteamHTMLRect::set_user_css);
+	ClassDB::bind_method(D_METHOD("get_user_css"), &SteamHTMLRect::get_user_css);
+	ClassDB::bind_method(D_METHOD("set_allow_navigation", "allow_navigation"), &SteamHTMLRect::set_allow_navigation);
+	ClassDB::bind_method(D_METHOD("get_allow_navigation"), &SteamHTMLRect::get_allow_navigation);
+	ClassDB::bind_method(D_METHOD("set_navigation_allowed", "allowed"), &SteamHTMLRect::set_navigation_allowed);
+	ClassDB::bind_method(D_METHOD("get_browser_handle"), &SteamHTMLRect::get_browser_handle);
+	ClassDB::bind_method(D_METHOD("get_texture"), &SteamHTMLRect::get_texture);
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "url"), "set_url", "get_url");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "user_agent"), "set_user_agent", "get_user_agent");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "user_css", PROPERTY_HINT_MULTILINE_TEXT), "set_user_css", "get_user_css");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_navigation"), "set_allow_navigation", "get_allow_navigation");
+	ADD_SIGNAL(MethodInfo("browser_ready", PropertyInfo(Variant::INT, "browser_handle")));
+	ADD_SIGNAL(MethodInfo("navigation_requested", PropertyInfo(Variant::STRING, "url"), PropertyInfo(Variant::STRING, "target"), PropertyInfo(Variant::STRING, "post_data"), PropertyInfo(Variant::BOOL, "redirect")));
+}
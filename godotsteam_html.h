@@ -0,0 +1,98 @@
+#ifndef GODOTSTEAM_HTML_H
+#define GODOTSTEAM_HTML_H
+
+/////////////////////////////////////////////////
+// INCLUDE HEADERS
+/////////////////////////////////////////////////
+//
+// Include INT types header
+#include <inttypes.h>
+
+// Include Steamworks API headers
+#include "steam/steam_api.h"
+
+// Include Godot headers
+#include "scene/gui/control.h"
+#include "scene/resources/texture.h"
+
+
+/////////////////////////////////////////////////
+///// HTML TEXTURE
+/////////////////////////////////////////////////
+//
+// A texture kept up to date with an HTML Surface browser; each html_needs_paint copies only the dirty rectangle, swizzled from BGRA, into the GPU texture.
+class SteamHTMLTexture : public ImageTexture {
+	GDCLASS(SteamHTMLTexture, ImageTexture);
+
+	public:
+		void set_browser_handle(uint32_t new_browser_handle);
+		uint32_t get_browser_handle() const;
+
+		void paint(const uint8_t* bgra, uint32_t wide, uint32_t tall, uint32_t update_x, uint32_t update_y, uint32_t update_wide, uint32_t update_tall);
+
+		SteamHTMLTexture();
+		~SteamHTMLTexture();
+
+	protected:
+		static void _bind_methods();
+
+	private:
+		uint32_t browser_handle;
+		uint32_t surface_wide;
+		uint32_t surface_tall;
+		PoolByteArray pixels;
+};
+
+
+/////////////////////////////////////////////////
+///// HTML RECT
+/////////////////////////////////////////////////
+//
+// A Control that creates its own browser while in the tree, keeps it sized to the control, forwards mouse and keyboard input to it and draws its SteamHTMLTexture. Navigation, JavaScript dialogs and file open dialogs of its browser are answered natively.
+class SteamHTMLRect : public Control {
+	GDCLASS(SteamHTMLRect, Control);
+
+	public:
+		void set_url(const String& new_url);
+		String get_url() const;
+		void set_user_agent(const String& new_user_agent);
+		String get_user_agent() const;
+		void set_user_css(const String& new_user_css);
+		String get_user_css() const;
+		void set_allow_navigation(bool new_allow_navigation);
+		bool get_allow_navigation() const;
+		void set_navigation_allowed(bool allowed);
+
+		uint32_t get_browser_handle() const;
+		Ref<SteamHTMLTexture> get_texture() const;
+
+		void start_request(const String& request_url, const String& target, const String& post_data, bool redirect);
+		void js_dialog(bool confirm);
+		void file_open_dialog();
+
+		SteamHTMLRect();
+
+	protected:
+		static void _bind_methods();
+		void _notification(int what);
+		void _gui_input(const Ref<InputEvent>& event);
+
+	private:
+		String url;
+		String user_agent;
+		String user_css;
+		bool allow_navigation;
+		bool navigation_allowed;
+		uint32_t browser_handle;
+		Ref<SteamHTMLTexture> texture;
+		CCallResult<SteamHTMLRect, HTML_BrowserReady_t> callResultBrowserReady;
+
+		void create_browser();
+		void remove_browser();
+		void browser_ready(HTML_BrowserReady_t* call_data, bool io_failure);
+		void _texture_changed();
+		static uint32_t get_native_key_code(uint32_t scancode);
+		static uint32_t get_key_modifiers(const Ref<InputEventWithModifiers>& event);
+};
+
+#endif // GODOTSTEAM_HTML_H
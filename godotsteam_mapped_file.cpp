@@ -0,0 +1,183 @@
+/////////////////////////////////////////////////
+///// HEADER INCLUDES
+/////////////////////////////////////////////////
+//
+// Include the mapped file header
+#include "godotsteam_mapped_file.h"
+
+// Include some Godot headers
+#include "core/project_settings.h"
+
+// Include the platform mapping headers
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/////////////////////////////////////////////////
+///// MAPPED FILE
+/////////////////////////////////////////////////
+//
+SteamMappedFile::SteamMappedFile(){
+	data = NULL;
+	size = 0;
+	writable = false;
+#ifdef _WIN32
+	file_handle = INVALID_HANDLE_VALUE;
+	mapping_handle = NULL;
+#else
+	file_descriptor = -1;
+#endif
+}
+
+SteamMappedFile::~SteamMappedFile(){
+	close();
+}
+
+// Open a file and map it into memory. Writable files are created or grown to the given size, read-only files are mapped at their current size.
+bool SteamMappedFile::open(const String& path, uint64_t new_size, bool new_writable){
+	close();
+	String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+	writable = new_writable;
+#ifdef _WIN32
+	file_handle = CreateFileW((LPCWSTR)global_path.c_str(), GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ, NULL, writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file_handle == INVALID_HANDLE_VALUE){
+		return false;
+	}
+	if(!writable){
+		LARGE_INTEGER file_size;
+		if(!GetFileSizeEx((HANDLE)file_handle, &file_size)){
+			close();
+			return false;
+		}
+		new_size = (uint64_t)file_size.QuadPart;
+	}
+#else
+	file_descriptor = ::open(global_path.utf8().get_data(), writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+	if(file_descriptor < 0){
+		return false;
+	}
+	if(writable){
+		if(ftruncate(file_descriptor, (off_t)new_size) != 0){
+			close();
+			return false;
+		}
+	}
+	else{
+		struct stat file_stat;
+		if(fstat(file_descriptor, &file_stat) != 0){
+			close();
+			return false;
+		}
+		new_size = (uint64_t)file_stat.st_size;
+	}
+#endif
+	size = new_size;
+	if(!map()){
+		close();
+		return false;
+	}
+	return true;
+}
+
+// Grow or shrink a writable mapping; the mapped address may change.
+bool SteamMappedFile::resize(uint64_t new_size){
+	if(!writable || new_size == 0){
+		return false;
+	}
+	unmap();
+#ifndef _WIN32
+	if(ftruncate(file_descriptor, (off_t)new_size) != 0){
+		return false;
+	}
+#endif
+	size = new_size;
+	return map();
+}
+
+// Ask the OS to start writing dirty pages back to disk.
+void SteamMappedFile::flush(){
+	if(data == NULL || !writable){
+		return;
+	}
+#ifdef _WIN32
+	FlushViewOfFile(data, 0);
+#else
+	msync(data, (size_t)size, MS_ASYNC);
+#endif
+}
+
+// Unmap and close the file, optionally truncating a writable file to the bytes actually used.
+void SteamMappedFile::close(uint64_t final_size){
+	unmap();
+#ifdef _WIN32
+	if(file_handle != INVALID_HANDLE_VALUE){
+		if(writable && final_size > 0){
+			LARGE_INTEGER end_of_file;
+			end_of_file.QuadPart = (LONGLONG)final_size;
+			SetFilePointerEx((HANDLE)file_handle, end_of_file, NULL, FILE_BEGIN);
+			SetEndOfFile((HANDLE)file_handle);
+		}
+		CloseHandle((HANDLE)file_handle);
+		file_handle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if(file_descriptor >= 0){
+		if(writable && final_size > 0){
+			if(ftruncate(file_descriptor, (off_t)final_size) != 0){
+				printf("[Steam] Failed to truncate mapped file.\n");
+			}
+		}
+		::close(file_descriptor);
+		file_descriptor = -1;
+	}
+#endif
+	size = 0;
+}
+
+bool SteamMappedFile::map(){
+	if(size == 0){
+		return false;
+	}
+#ifdef _WIN32
+	mapping_handle = CreateFileMappingW((HANDLE)file_handle, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), NULL);
+	if(mapping_handle == NULL){
+		return false;
+	}
+	data = (uint8_t*)MapViewOfFile((HANDLE)mapping_handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)size);
+	if(data == NULL){
+		CloseHandle((HANDLE)mapping_handle);
+		mapping_handle = NULL;
+		return false;
+	}
+#else
+	void* mapped = mmap(NULL, (size_t)size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, file_descriptor, 0);
+	if(mapped == MAP_FAILED){
+		return false;
+	}
+	data = (uint8_t*)mapped;
+#endif
+	return true;
+}
+
+void SteamMappedFile::unmap(){
+	if(data == NULL){
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle((HANDLE)mapping_handle);
+	mapping_handle = NULL;
+#else
+	munmap(data, (size_t)size);
+#endif
+	data = NULL;
+}
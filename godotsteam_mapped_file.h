@@ -0,0 +1,45 @@
+#ifndef GODOTSTEAM_MAPPED_FILE_H
+#define GODOTSTEAM_MAPPED_FILE_H
+
+/////////////////////////////////////////////////
+// INCLUDE HEADERS
+/////////////////////////////////////////////////
+//
+// Include INT types header
+#include <inttypes.h>
+
+// Include Godot headers
+#include "core/ustring.h"
+
+// A read / write memory-mapped file, used by the message capture log and the server list cache. Platform headers stay in the source file so they never leak into godotsteam.cpp.
+class SteamMappedFile {
+	public:
+		SteamMappedFile();
+		~SteamMappedFile();
+
+		bool open(const String& path, uint64_t size, bool writable);
+		bool resize(uint64_t size);
+		void flush();
+		void close(uint64_t final_size = 0);
+
+		bool is_open() const { return data != NULL; }
+		bool is_writable() const { return writable; }
+		uint8_t* get_data() const { return data; }
+		uint64_t get_size() const { return size; }
+
+	private:
+		bool map();
+		void unmap();
+
+		uint8_t* data;
+		uint64_t size;
+		bool writable;
+#ifdef _WIN32
+		void* file_handle;
+		void* mapping_handle;
+#else
+		int file_descriptor;
+#endif
+};
+
+#endif // GODOTSTEAM_MAPPED_FILE_H
@@ -0,0 +1,862 @@
+/////////////////////////////////////////////////
+///// HEADER INCLUDES
+/////////////////////////////////////////////////
+//
+// Include the servers header
+#include "godotsteam_servers.h"
+
+// Include Godot headers
+#include "core/os/os.h"
+
+// Include GodotSteam header
+#include "godotsteam.h"
+#include "godotsteam_mapped_file.h"
+
+// Include some system headers
+#include "algorithm"
+
+
+/////////////////////////////////////////////////
+///// DEFINING CONSTANTS
+/////////////////////////////////////////////////
+//
+// Define Server List cache constants
+#define SERVER_CACHE_MAGIC "GSSVRIDX"
+#define SERVER_CACHE_VERSION 1
+
+// Define Server Query constants
+#define SERVER_QUERY_REAPED_MAX 64
+
+// Header of a server list cache file; fixed size gameserveritem_t records follow it.
+struct ServerCacheHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t count;
+	uint32_t reserved;
+};
+
+
+/////////////////////////////////////////////////
+///// HELPERS
+/////////////////////////////////////////////////
+//
+// Check a comma separated tag list for a whole tag.
+static bool has_server_tag(const char* tags, const char* tag, size_t tag_length){
+	const char* start = tags;
+	while(*start != '\0'){
+		const char* end = strchr(start, ',');
+		size_t length = (end != NULL) ? (size_t)(end - start) : strlen(start);
+		if(length == tag_length && strncmp(start, tag, length) == 0){
+			return true;
+		}
+		if(end == NULL){
+			break;
+		}
+		start = end + 1;
+	}
+	return false;
+}
+
+// Join tags into the comma separated list Steam filters expect.
+static String join_server_tags(const PoolStringArray& tags){
+	String joined;
+	for(int i = 0; i < tags.size(); i++){
+		if(i > 0){
+			joined += ",";
+		}
+		joined += tags[i];
+	}
+	return joined;
+}
+
+
+/////////////////////////////////////////////////
+///// SERVER FILTER
+/////////////////////////////////////////////////
+//
+SteamServerFilter::SteamServerFilter(){
+	pairs_dirty = false;
+}
+
+// Append any matchmaking filter pair, such as gamedataand or collapse_addr_hash, that has no typed setter. Pairs are sent in the order they were added and the same key may be added more than once, as the compound filters or, and, nor and nand need.
+void SteamServerFilter::add_filter(const String& key, const String& value){
+	if(!fits(key, value)){
+		return;
+	}
+	filters.push_back(std::make_pair(key, value));
+	pairs_dirty = true;
+}
+
+// Remove every pair with this key.
+void SteamServerFilter::remove_filter(const String& key){
+	for(uint32_t i = 0; i < filters.size();){
+		if(filters[i].first == key){
+			filters.erase(filters.begin() + i);
+			pairs_dirty = true;
+		}
+		else{
+			i++;
+		}
+	}
+}
+
+void SteamServerFilter::clear(){
+	filters.clear();
+	pairs_dirty = true;
+}
+
+// Get the filters in order as [key, value] arrays.
+Array SteamServerFilter::get_filters() const {
+	Array current;
+	for(uint32_t i = 0; i < filters.size(); i++){
+		Array pair;
+		pair.append(filters[i].first);
+		pair.append(filters[i].second);
+		current.append(pair);
+	}
+	return current;
+}
+
+void SteamServerFilter::set_dedicated(bool dedicated){
+	set_flag("dedicated", dedicated);
+}
+
+void SteamServerFilter::set_secure(bool secure){
+	set_flag("secure", secure);
+}
+
+void SteamServerFilter::set_not_full(bool not_full){
+	set_flag("full", not_full);
+}
+
+void SteamServerFilter::set_not_empty(bool not_empty){
+	set_flag("empty", not_empty);
+}
+
+void SteamServerFilter::set_map(const String& map){
+	set_text("map", map);
+}
+
+void SteamServerFilter::set_game_dir(const String& game_dir){
+	set_text("gamedir", game_dir);
+}
+
+// Server names may use * as a wildcard.
+void SteamServerFilter::set_name_match(const String& name){
+	set_text("name_match", name);
+}
+
+// Versions may use * as a wildcard.
+void SteamServerFilter::set_version_match(const String& version){
+	set_text("version_match", version);
+}
+
+// Only list servers that have every one of these tags.
+void SteamServerFilter::set_tags(PoolStringArray tags){
+	set_text("gametagsand", join_server_tags(tags));
+}
+
+// Hide servers that have any of these tags.
+void SteamServerFilter::set_excluded_tags(PoolStringArray tags){
+	set_text("gametagsnor", join_server_tags(tags));
+}
+
+// Get the filters in the layout the request*ServerList calls take; the pairs stay valid until the filter next changes.
+MatchMakingKeyValuePair_t* SteamServerFilter::get_pairs(uint32& count){
+	if(pairs_dirty){
+		pairs.clear();
+		pairs.reserve(filters.size());
+		for(uint32_t i = 0; i < filters.size(); i++){
+			pairs.push_back(MatchMakingKeyValuePair_t(filters[i].first.utf8().get_data(), filters[i].second.utf8().get_data()));
+		}
+		pairs_dirty = false;
+	}
+	count = pairs.size();
+	return pairs.empty() ? NULL : &pairs[0];
+}
+
+bool SteamServerFilter::fits(const String& key, const String& value) const {
+	if(key.utf8().length() >= (int)sizeof(MatchMakingKeyValuePair_t().m_szKey) || value.utf8().length() >= (int)sizeof(MatchMakingKeyValuePair_t().m_szValue)){
+		printf("[Steam] Server filter %s is too long.\n", key.utf8().get_data());
+		return false;
+	}
+	return true;
+}
+
+// Typed setters own their key: change its pair where it is, or append it if it is not set yet.
+void SteamServerFilter::replace_filter(const String& key, const String& value){
+	if(!fits(key, value)){
+		return;
+	}
+	for(uint32_t i = 0; i < filters.size(); i++){
+		if(filters[i].first == key){
+			filters[i].second = value;
+			pairs_dirty = true;
+			return;
+		}
+	}
+	filters.push_back(std::make_pair(key, value));
+	pairs_dirty = true;
+}
+
+void SteamServerFilter::set_flag(const String& key, bool enabled){
+	if(enabled){
+		replace_filter(key, "1");
+	}
+	else{
+		remove_filter(key);
+	}
+}
+
+void SteamServerFilter::set_text(const String& key, const String& value){
+	if(value.empty()){
+		remove_filter(key);
+	}
+	else{
+		replace_filter(key, value);
+	}
+}
+
+void SteamServerFilter::_bind_methods(){
+	ClassDB::bind_method(D_METHOD("add_filter", "key", "value"), &SteamServerFilter::add_filter);
+	ClassDB::bind_method(D_METHOD("remove_filter", "key"), &SteamServerFilter::remove_filter);
+	ClassDB::bind_method(D_METHOD("clear"), &SteamServerFilter::clear);
+	ClassDB::bind_method(D_METHOD("get_filters"), &SteamServerFilter::get_filters);
+	ClassDB::bind_method(D_METHOD("set_dedicated", "dedicated"), &SteamServerFilter::set_dedicated);
+	ClassDB::bind_method(D_METHOD("set_secure", "secure"), &SteamServerFilter::set_secure);
+	ClassDB::bind_method(D_METHOD("set_not_full", "not_full"), &SteamServerFilter::set_not_full);
+	ClassDB::bind_method(D_METHOD("set_not_empty", "not_empty"), &SteamServerFilter::set_not_empty);
+	ClassDB::bind_method(D_METHOD("set_map", "map"), &SteamServerFilter::set_map);
+	ClassDB::bind_method(D_METHOD("set_game_dir", "game_dir"), &SteamServerFilter::set_game_dir);
+	ClassDB::bind_method(D_METHOD("set_name_match", "name"), &SteamServerFilter::set_name_match);
+	ClassDB::bind_method(D_METHOD("set_version_match", "version"), &SteamServerFilter::set_version_match);
+	ClassDB::bind_method(D_METHOD("set_tags", "tags"), &SteamServerFilter::set_tags);
+	ClassDB::bind_method(D_METHOD("set_excluded_tags", "tags"), &SteamServerFilter::set_excluded_tags);
+}
+
+
+/////////////////////////////////////////////////
+///// SERVER LIST
+/////////////////////////////////////////////////
+//
+SteamServerList::SteamServerList(){
+	request = NULL;
+	view_dirty = false;
+	changed = false;
+	sort_field = SORT_PING;
+	sort_ascending = true;
+	max_ping = 0;
+	min_players = 0;
+	hide_full = false;
+	hide_empty = false;
+	hide_password = false;
+	secure_only = false;
+	hide_unresponsive = true;
+}
+
+// Drop every captured server, ready for a new request.
+void SteamServerList::clear(){
+	request = NULL;
+	entries.clear();
+	entry_index.clear();
+	address_index.clear();
+	view.clear();
+	view_dirty = false;
+	changed = true;
+	cache_path = "";
+}
+
+// Only responses for this request are captured; the list is cleared when it changes.
+void SteamServerList::set_request(HServerListRequest new_request){
+	if(new_request != request){
+		clear();
+		request = new_request;
+	}
+}
+
+void SteamServerList::set_sort(int field, bool ascending){
+	sort_field = field;
+	sort_ascending = ascending;
+	view_dirty = true;
+}
+
+// Read filter settings from a dictionary; keys left out reset to showing everything.
+void SteamServerList::set_filter(const Dictionary& filter){
+	max_ping = filter.get("max_ping", 0);
+	min_players = filter.get("min_players", 0);
+	hide_full = filter.get("hide_full", false);
+	hide_empty = filter.get("hide_empty", false);
+	hide_password = filter.get("hide_password", false);
+	secure_only = filter.get("secure_only", false);
+	hide_unresponsive = filter.get("hide_unresponsive", true);
+	map = filter.get("map", "");
+	tags.clear();
+	PoolStringArray filter_tags = filter.get("tags", PoolStringArray());
+	for(int i = 0; i < filter_tags.size(); i++){
+		tags.push_back(filter_tags[i].utf8());
+	}
+	view_dirty = true;
+}
+
+// Number of servers that pass the filter.
+uint32_t SteamServerList::get_count(){
+	update_view();
+	return view.size();
+}
+
+// Get a window of the sorted, filtered list as dictionaries; only this window is converted.
+Array SteamServerList::get_page(uint32_t offset, uint32_t count){
+	update_view();
+	Array page;
+	uint32_t end = MIN(offset + count, (uint32_t)view.size());
+	for(uint32_t i = offset; i < end; i++){
+		const Entry &entry = entries[view[i]];
+		Dictionary server = item_to_dictionary(entry.item);
+		server["server"] = entry.server;
+		server["cached"] = entry.cached;
+		server["stale"] = entry.stale;
+		page.append(server);
+	}
+	return page;
+}
+
+// Returns true once after servers were added or updated.
+bool SteamServerList::take_changed(){
+	bool was_changed = changed;
+	changed = false;
+	return was_changed;
+}
+
+// Fill the list with the servers saved by the last refresh of this request type, so it can be shown before any response arrives. Live responses replace the cached servers by address, while servers that fail to respond keep their cached details marked stale. The list is saved back when a refresh completes successfully.
+bool SteamServerList::use_cache(const String& path){
+	cache_path = path;
+	if(path.empty()){
+		return false;
+	}
+	SteamMappedFile file;
+	if(!file.open(path, 0, false)){
+		return false;
+	}
+	const ServerCacheHeader *header = (const ServerCacheHeader*)file.get_data();
+	// Files from another version or SDK are ignored and replaced on the next save
+	if(file.get_size() < sizeof(ServerCacheHeader) || memcmp(header->magic, SERVER_CACHE_MAGIC, sizeof(header->magic)) != 0 || header->version != SERVER_CACHE_VERSION || header->record_size != sizeof(gameserveritem_t)){
+		file.close();
+		return false;
+	}
+	uint32_t count = MIN((uint64_t)header->count, (file.get_size() - sizeof(ServerCacheHeader)) / sizeof(gameserveritem_t));
+	const uint8_t* records = file.get_data() + sizeof(ServerCacheHeader);
+	for(uint32_t i = 0; i < count; i++){
+		Entry entry;
+		memcpy(&entry.item, records + i * sizeof(gameserveritem_t), sizeof(gameserveritem_t));
+		uint64_t address = address_key(entry.item);
+		if(address_index.find(address) != address_index.end()){
+			continue;
+		}
+		// Cached servers use negative indices until Steam reports them
+		entry.server = -1 - (int)i;
+		entry.cached = true;
+		entry.stale = false;
+		entry_index[entry.server] = entries.size();
+		address_index[address] = entries.size();
+		entries.push_back(entry);
+	}
+	file.close();
+	view_dirty = true;
+	changed = true;
+	return count > 0;
+}
+
+Dictionary SteamServerList::item_to_dictionary(const gameserveritem_t& item){
+	Dictionary game_server;
+	game_server["ip"] = item.m_NetAdr.GetIP();
+	game_server["connection_port"] = item.m_NetAdr.GetConnectionPort();
+	game_server["query_port"] = item.m_NetAdr.GetQueryPort();
+	game_server["ping"] = item.m_nPing;
+	game_server["success_response"] = item.m_bHadSuccessfulResponse;
+	game_server["no_refresh"] = item.m_bDoNotRefresh;
+	game_server["game_dir"] = String::utf8(item.m_szGameDir);
+	game_server["map"] = String::utf8(item.m_szMap);
+	game_server["description"] = String::utf8(item.m_szGameDescription);
+	game_server["app_id"] = item.m_nAppID;
+	game_server["players"] = item.m_nPlayers;
+	game_server["max_players"] = item.m_nMaxPlayers;
+	game_server["bot_players"] = item.m_nBotPlayers;
+	game_server["password"] = item.m_bPassword;
+	game_server["secure"] = item.m_bSecure;
+	game_server["last_played"] = item.m_ulTimeLastPlayed;
+	game_server["server_version"] = item.m_nServerVersion;
+	game_server["name"] = String::utf8(item.GetName());
+	game_server["tags"] = String::utf8(item.m_szGameTags);
+	game_server["steam_id"] = (uint64_t)item.m_steamID.ConvertToUint64();
+	return game_server;
+}
+
+void SteamServerList::ServerResponded(HServerListRequest this_request, int server){
+	capture(this_request, server);
+}
+
+// Failed servers are kept so a later refresh can update them in place; the unresponsive filter hides them.
+void SteamServerList::ServerFailedToRespond(HServerListRequest this_request, int server){
+	capture(this_request, server);
+}
+
+void SteamServerList::RefreshComplete(HServerListRequest this_request, EMatchMakingServerResponse response){
+	if(this_request != request){
+		return;
+	}
+	// A failed refresh would replace the cache with whatever little arrived
+	if(!cache_path.empty() && response == eServerResponded){
+		drop_cached();
+		save_cache();
+	}
+	Steam* steam = Steam::get_singleton();
+	if(steam != NULL){
+		steam->emit_signal("server_list_refresh_complete", (uint64_t)this_request, response);
+	}
+}
+
+// Copy the server's details into the flat array, updating its existing entry on refreshes. A failed response does not overwrite details taken from the cache; they are kept and marked stale instead.
+void SteamServerList::capture(HServerListRequest this_request, int server){
+	if(this_request != request || SteamMatchmakingServers() == NULL){
+		return;
+	}
+	gameserveritem_t* item = SteamMatchmakingServers()->GetServerDetails(this_request, server);
+	if(item == NULL){
+		return;
+	}
+	std::unordered_map<int, uint32_t>::iterator found = entry_index.find(server);
+	if(found != entry_index.end()){
+		Entry &entry = entries[found->second];
+		if(item->m_bHadSuccessfulResponse || !entry.stale){
+			entry.item = *item;
+			entry.stale = false;
+		}
+	}
+	else{
+		// A cached server reported live takes over its cached entry
+		uint64_t address = address_key(*item);
+		std::unordered_map<uint64_t, uint32_t>::iterator cached = address_index.find(address);
+		if(cached != address_index.end() && entries[cached->second].cached){
+			Entry &entry = entries[cached->second];
+			entry_index.erase(entry.server);
+			entry.server = server;
+			entry.cached = false;
+			entry.stale = !item->m_bHadSuccessfulResponse;
+			if(!entry.stale){
+				entry.item = *item;
+			}
+			entry_index[server] = cached->second;
+		}
+		else{
+			Entry entry;
+			entry.server = server;
+			entry.cached = false;
+			entry.stale = false;
+			entry.item = *item;
+			entry_index[server] = entries.size();
+			address_index[address] = entries.size();
+			entries.push_back(entry);
+		}
+	}
+	view_dirty = true;
+	changed = true;
+}
+
+// Remove cached servers Steam did not report, such as favorites removed since the cache was saved. Stale servers were reported, so they stay.
+void SteamServerList::drop_cached(){
+	uint32_t kept = 0;
+	for(uint32_t i = 0; i < entries.size(); i++){
+		if(!entries[i].cached){
+			entries[kept++] = entries[i];
+		}
+	}
+	if(kept == entries.size()){
+		return;
+	}
+	entries.resize(kept);
+	entry_index.clear();
+	address_index.clear();
+	for(uint32_t i = 0; i < entries.size(); i++){
+		entry_index[entries[i].server] = i;
+		address_index[address_key(entries[i].item)] = i;
+	}
+	view_dirty = true;
+	changed = true;
+}
+
+// Write every server of the list to the cache file as raw records.
+bool SteamServerList::save_cache(){
+	uint64_t size = sizeof(ServerCacheHeader) + entries.size() * sizeof(gameserveritem_t);
+	SteamMappedFile file;
+	if(!file.open(cache_path, size, true)){
+		printf("[Steam] Failed to write server list cache.\n");
+		return false;
+	}
+	ServerCacheHeader *header = (ServerCacheHeader*)file.get_data();
+	memset(header, 0, sizeof(ServerCacheHeader));
+	memcpy(header->magic, SERVER_CACHE_MAGIC, sizeof(header->magic));
+	header->version = SERVER_CACHE_VERSION;
+	header->record_size = sizeof(gameserveritem_t);
+	header->count = entries.size();
+	uint8_t* records = file.get_data() + sizeof(ServerCacheHeader);
+	for(uint32_t i = 0; i < entries.size(); i++){
+		memcpy(records + i * sizeof(gameserveritem_t), &entries[i].item, sizeof(gameserveritem_t));
+	}
+	file.flush();
+	file.close(size);
+	return true;
+}
+
+uint64_t SteamServerList::address_key(const gameserveritem_t& item){
+	return ((uint64_t)item.m_NetAdr.GetIP() << 16) | item.m_NetAdr.GetQueryPort();
+}
+
+bool SteamServerList::passes(const gameserveritem_t& item) const {
+	if(hide_unresponsive && !item.m_bHadSuccessfulResponse){
+		return false;
+	}
+	if(max_ping > 0 && item.m_nPing > max_ping){
+		return false;
+	}
+	if(item.m_nPlayers < min_players){
+		return false;
+	}
+	if(hide_full && item.m_nMaxPlayers > 0 && item.m_nPlayers >= item.m_nMaxPlayers){
+		return false;
+	}
+	if(hide_empty && item.m_nPlayers == 0){
+		return false;
+	}
+	if(hide_password && item.m_bPassword){
+		return false;
+	}
+	if(secure_only && !item.m_bSecure){
+		return false;
+	}
+	for(uint32_t i = 0; i < tags.size(); i++){
+		if(!has_server_tag(item.m_szGameTags, tags[i].get_data(), tags[i].length())){
+			return false;
+		}
+	}
+	if(!map.empty() && String::utf8(item.m_szMap).findn(map) == -1){
+		return false;
+	}
+	return true;
+}
+
+// Rebuild the filtered and sorted view only when servers or settings changed since the last read.
+void SteamServerList::update_view(){
+	if(!view_dirty){
+		return;
+	}
+	view.clear();
+	view.reserve(entries.size());
+	for(uint32_t i = 0; i < entries.size(); i++){
+		if(passes(entries[i].item)){
+			view.push_back(i);
+		}
+	}
+	EntryCompare compare;
+	compare.entries = &entries;
+	compare.field = sort_field;
+	compare.ascending = sort_ascending;
+	std::stable_sort(view.begin(), view.end(), compare);
+	view_dirty = false;
+}
+
+bool SteamServerList::EntryCompare::operator()(uint32_t a, uint32_t b) const {
+	const gameserveritem_t &first = (*entries)[ascending ? a : b].item;
+	const gameserveritem_t &second = (*entries)[ascending ? b : a].item;
+	switch(field){
+		case SORT_PLAYERS:
+			return first.m_nPlayers < second.m_nPlayers;
+		case SORT_MAP:
+			return strcmp(first.m_szMap, second.m_szMap) < 0;
+		case SORT_NAME:
+			return strcmp(first.GetName(), second.GetName()) < 0;
+		default:
+			return first.m_nPing < second.m_nPing;
+	}
+}
+
+
+/////////////////////////////////////////////////
+///// SERVER QUERY
+/////////////////////////////////////////////////
+//
+SteamServerQuery::SteamServerQuery(uint64_t new_job, int new_kind, uint64_t new_started){
+	job = new_job;
+	kind = new_kind;
+	handle = HSERVERQUERY_INVALID;
+	started = new_started;
+	done = false;
+	failed = false;
+}
+
+void SteamServerQuery::ServerResponded(gameserveritem_t& server){
+	details = SteamServerList::item_to_dictionary(server);
+	done = true;
+}
+
+void SteamServerQuery::ServerFailedToRespond(){
+	failed = true;
+	done = true;
+}
+
+void SteamServerQuery::AddPlayerToList(const char* name, int score, float time_played){
+	Dictionary player;
+	player["name"] = String::utf8(name);
+	player["score"] = score;
+	player["time_played"] = time_played;
+	players.append(player);
+}
+
+void SteamServerQuery::PlayersFailedToRespond(){
+	failed = true;
+	done = true;
+}
+
+void SteamServerQuery::PlayersRefreshComplete(){
+	done = true;
+}
+
+void SteamServerQuery::RulesResponded(const char* rule, const char* value){
+	rules[String::utf8(rule)] = String::utf8(value);
+}
+
+void SteamServerQuery::RulesFailedToRespond(){
+	failed = true;
+	done = true;
+}
+
+void SteamServerQuery::RulesRefreshComplete(){
+	done = true;
+}
+
+
+/////////////////////////////////////////////////
+///// SERVER QUERIES
+/////////////////////////////////////////////////
+//
+SteamServerQueries::SteamServerQueries(){
+	max_in_flight = 8;
+	timeout = 2000000;
+	sequence = 0;
+}
+
+SteamServerQueries::~SteamServerQueries(){
+	clear();
+}
+
+// Set how many queries may run at once and how long, in microseconds, one may run before it is cancelled; a timeout of 0 lets queries run until Steam answers.
+void SteamServerQueries::set_limits(uint32_t new_max_in_flight, uint64_t new_timeout){
+	max_in_flight = MAX(new_max_in_flight, (uint32_t)1);
+	timeout = new_timeout;
+}
+
+// Queue queries for a server, or change the priority of ones already queued; higher priorities start first.
+bool SteamServerQueries::queue(uint32 ip, uint16 port, int kinds, int priority){
+	kinds &= (QUERY_PING | QUERY_PLAYERS | QUERY_RULES);
+	if(kinds == 0){
+		return false;
+	}
+	uint64_t key = ((uint64_t)ip << 16) | port;
+	Job &job = get_job(ip, port);
+	if(job.kinds != 0){
+		PendingKey old_key = { job.priority, job.sequence, key };
+		pending.erase(old_key);
+	}
+	job.kinds |= kinds & ~job.running;
+	job.priority = priority;
+	if(job.kinds != 0){
+		PendingKey new_key = { job.priority, job.sequence, key };
+		pending.insert(new_key);
+	}
+	return true;
+}
+
+// Start one query straight away, outside the in-flight limit.
+HServerQuery SteamServerQueries::start(uint32 ip, uint16 port, int kind){
+	uint64_t key = ((uint64_t)ip << 16) | port;
+	Job &job = get_job(ip, port);
+	// Already running, so share it
+	if(job.running & kind){
+		for(uint32_t i = 0; i < in_flight.size(); i++){
+			if(in_flight[i]->job == key && in_flight[i]->kind == kind){
+				return in_flight[i]->handle;
+			}
+		}
+	}
+	if(job.kinds & kind){
+		job.kinds &= ~kind;
+		if(job.kinds == 0){
+			PendingKey old_key = { job.priority, job.sequence, key };
+			pending.erase(old_key);
+		}
+	}
+	return launch(key, job, kind, OS::get_singleton()->get_ticks_usec());
+}
+
+// Cancel one running query; it is reported as failed on the next update.
+bool SteamServerQueries::cancel(HServerQuery handle){
+	for(uint32_t i = 0; i < in_flight.size(); i++){
+		if(in_flight[i]->handle == handle && !in_flight[i]->done){
+			if(SteamMatchmakingServers() != NULL){
+				SteamMatchmakingServers()->CancelServerQuery(handle);
+			}
+			in_flight[i]->failed = true;
+			in_flight[i]->done = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Was this handle one of the last few finished queries, so cancelling it has nothing left to do.
+bool SteamServerQueries::was_reaped(HServerQuery handle) const {
+	return std::find(reaped.begin(), reaped.end(), handle) != reaped.end();
+}
+
+// Drop queued queries that have not started; running ones still finish.
+void SteamServerQueries::cancel_pending(){
+	for(std::set<PendingKey>::iterator queued = pending.begin(); queued != pending.end(); ++queued){
+		std::map<uint64_t, Job>::iterator job = jobs.find(queued->job);
+		job->second.kinds = 0;
+		if(job->second.running == 0){
+			jobs.erase(job);
+		}
+	}
+	pending.clear();
+}
+
+// Cancel every query, running or not.
+void SteamServerQueries::clear(){
+	for(uint32_t i = 0; i < in_flight.size(); i++){
+		if(!in_flight[i]->done && in_flight[i]->handle != HSERVERQUERY_INVALID && SteamMatchmakingServers() != NULL){
+			SteamMatchmakingServers()->CancelServerQuery(in_flight[i]->handle);
+		}
+		memdelete(in_flight[i]);
+	}
+	in_flight.clear();
+	pending.clear();
+	jobs.clear();
+	reaped.clear();
+}
+
+// Collect finished and timed out queries, hand back servers with nothing left to run, then start queued queries while there is room.
+void SteamServerQueries::update(uint64_t now, std::vector<Result>& completed){
+	for(uint32_t i = 0; i < in_flight.size();){
+		SteamServerQuery* query = in_flight[i];
+		if(!query->done && (timeout == 0 || now - query->started < timeout)){
+			i++;
+			continue;
+		}
+		if(!query->done){
+			if(SteamMatchmakingServers() != NULL){
+				SteamMatchmakingServers()->CancelServerQuery(query->handle);
+			}
+			query->failed = true;
+		}
+		in_flight[i] = in_flight.back();
+		in_flight.pop_back();
+		uint64_t key = query->job;
+		finish(query);
+		std::map<uint64_t, Job>::iterator job = jobs.find(key);
+		if(job != jobs.end() && job->second.running == 0 && job->second.kinds == 0){
+			Result result;
+			result.ip = job->second.ip;
+			result.port = job->second.port;
+			result.data = job->second.result;
+			result.data["failed"] = job->second.failed;
+			completed.push_back(result);
+			jobs.erase(job);
+		}
+	}
+	while(in_flight.size() < max_in_flight && !pending.empty()){
+		PendingKey next = *pending.begin();
+		Job &job = jobs[next.job];
+		int kind = job.kinds & -job.kinds;
+		job.kinds &= ~kind;
+		if(job.kinds == 0){
+			pending.erase(pending.begin());
+		}
+		launch(next.job, job, kind, now);
+	}
+}
+
+SteamServerQueries::Job& SteamServerQueries::get_job(uint32 ip, uint16 port){
+	uint64_t key = ((uint64_t)ip << 16) | port;
+	std::map<uint64_t, Job>::iterator found = jobs.find(key);
+	if(found != jobs.end()){
+		return found->second;
+	}
+	Job &job = jobs[key];
+	job.ip = ip;
+	job.port = port;
+	job.kinds = 0;
+	job.running = 0;
+	job.failed = 0;
+	job.priority = 0;
+	job.sequence = sequence++;
+	return job;
+}
+
+HServerQuery SteamServerQueries::launch(uint64_t key, Job& job, int kind, uint64_t now){
+	SteamServerQuery* query = memnew(SteamServerQuery(key, kind, now));
+	if(SteamMatchmakingServers() != NULL){
+		switch(kind){
+			case QUERY_PING:
+				query->handle = SteamMatchmakingServers()->PingServer(job.ip, job.port, query);
+				break;
+			case QUERY_PLAYERS:
+				query->handle = SteamMatchmakingServers()->PlayerDetails(job.ip, job.port, query);
+				break;
+			case QUERY_RULES:
+				query->handle = SteamMatchmakingServers()->ServerRules(job.ip, job.port, query);
+				break;
+		}
+	}
+	// Queries that could not start fail on the next update
+	if(query->handle == HSERVERQUERY_INVALID){
+		query->failed = true;
+		query->done = true;
+	}
+	// Steam reuses handles, so a new query's handle no longer names a reaped one
+	else{
+		std::deque<HServerQuery>::iterator old = std::find(reaped.begin(), reaped.end(), query->handle);
+		if(old != reaped.end()){
+			reaped.erase(old);
+		}
+	}
+	job.running |= kind;
+	in_flight.push_back(query);
+	return query->handle;
+}
+
+// Move a finished query's results into its server's result and free it, remembering its handle for a while.
+void SteamServerQueries::finish(SteamServerQuery* query){
+	if(query->handle != HSERVERQUERY_INVALID){
+		reaped.push_back(query->handle);
+		if(reaped.size() > SERVER_QUERY_REAPED_MAX){
+			reaped.pop_front();
+		}
+	}
+	std::map<uint64_t, Job>::iterator job = jobs.find(query->job);
+	if(job != jobs.end()){
+		job->second.running &= ~query->kind;
+		if(query->failed){
+			job->second.failed |= query->kind;
+		}
+		else if(query->kind == QUERY_PING){
+			job->second.result["ping"] = query->details;
+		}
+		else if(query->kind == QUERY_PLAYERS){
+			job->second.result["players"] = query->players;
+		}
+		else if(query->kind == QUERY_RULES){
+			job->second.result["rules"] = query->rules;
+		}
+	}
+	memdelete(query);
+}
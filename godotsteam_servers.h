@@ -0,0 +1,249 @@
+#ifndef GODOTSTEAM_SERVERS_H
+#define GODOTSTEAM_SERVERS_H
+
+/////////////////////////////////////////////////
+// INCLUDE HEADERS
+/////////////////////////////////////////////////
+//
+// Include INT types header
+#include <inttypes.h>
+
+// Include Steamworks API headers
+#include "steam/steam_api.h"
+
+// Include Godot headers
+#include "core/array.h"
+#include "core/dictionary.h"
+#include "core/reference.h"
+#include "core/ustring.h"
+
+// Include some system headers
+#include "deque"
+#include "map"
+#include "set"
+#include "unordered_map"
+#include "vector"
+
+
+/////////////////////////////////////////////////
+///// SERVER FILTER
+/////////////////////////////////////////////////
+//
+// Matchmaking server filters built once from typed setters. The key / value pairs Steam reads are kept in order, since compound filters such as or and nand apply to the pairs after them, and only rebuilt after a change, so one filter can be passed to every request*ServerList call and refresh.
+class SteamServerFilter : public Reference {
+	GDCLASS(SteamServerFilter, Reference);
+
+	public:
+		void add_filter(const String& key, const String& value);
+		void remove_filter(const String& key);
+		void clear();
+		Array get_filters() const;
+
+		void set_dedicated(bool dedicated);
+		void set_secure(bool secure);
+		void set_not_full(bool not_full);
+		void set_not_empty(bool not_empty);
+		void set_map(const String& map);
+		void set_game_dir(const String& game_dir);
+		void set_name_match(const String& name);
+		void set_version_match(const String& version);
+		void set_tags(PoolStringArray tags);
+		void set_excluded_tags(PoolStringArray tags);
+
+		MatchMakingKeyValuePair_t* get_pairs(uint32& count);
+
+		SteamServerFilter();
+
+	protected:
+		static void _bind_methods();
+
+	private:
+		bool fits(const String& key, const String& value) const;
+		void replace_filter(const String& key, const String& value);
+		void set_flag(const String& key, bool enabled);
+		void set_text(const String& key, const String& value);
+
+		std::vector<std::pair<String, String>> filters;
+		std::vector<MatchMakingKeyValuePair_t> pairs;
+		bool pairs_dirty;
+};
+
+
+/////////////////////////////////////////////////
+///// SERVER LIST
+/////////////////////////////////////////////////
+//
+// Receives a server list request's responses and keeps each gameserveritem_t in one flat array. Sorting and filtering only rebuild an index view, so script can page through thousands of servers without a Dictionary per server.
+class SteamServerList : public ISteamMatchmakingServerListResponse {
+	public:
+		enum SortField {
+			SORT_PING = 0, SORT_PLAYERS = 1, SORT_MAP = 2, SORT_NAME = 3
+		};
+
+		SteamServerList();
+
+		void clear();
+		void set_request(HServerListRequest new_request);
+		HServerListRequest get_request() const { return request; }
+		void set_sort(int field, bool ascending);
+		void set_filter(const Dictionary& filter);
+		uint32_t get_count();
+		uint32_t get_total() const { return entries.size(); }
+		Array get_page(uint32_t offset, uint32_t count);
+		bool take_changed();
+		bool use_cache(const String& path);
+
+		static Dictionary item_to_dictionary(const gameserveritem_t& item);
+
+		// ISteamMatchmakingServerListResponse
+		virtual void ServerResponded(HServerListRequest this_request, int server);
+		virtual void ServerFailedToRespond(HServerListRequest this_request, int server);
+		virtual void RefreshComplete(HServerListRequest this_request, EMatchMakingServerResponse response);
+
+	private:
+		struct Entry {
+			int server;
+			bool cached;
+			bool stale;
+			gameserveritem_t item;
+		};
+		struct EntryCompare {
+			const std::vector<Entry>* entries;
+			int field;
+			bool ascending;
+			bool operator()(uint32_t a, uint32_t b) const;
+		};
+
+		void capture(HServerListRequest this_request, int server);
+		bool passes(const gameserveritem_t& item) const;
+		void update_view();
+		void drop_cached();
+		bool save_cache();
+		static uint64_t address_key(const gameserveritem_t& item);
+
+		HServerListRequest request;
+		std::vector<Entry> entries;
+		std::unordered_map<int, uint32_t> entry_index;
+		std::unordered_map<uint64_t, uint32_t> address_index;
+		std::vector<uint32_t> view;
+		bool view_dirty;
+		bool changed;
+		int sort_field;
+		bool sort_ascending;
+		int max_ping;
+		int min_players;
+		bool hide_full;
+		bool hide_empty;
+		bool hide_password;
+		bool secure_only;
+		bool hide_unresponsive;
+		String map;
+		std::vector<CharString> tags;
+		String cache_path;
+};
+
+
+/////////////////////////////////////////////////
+///// SERVER QUERIES
+/////////////////////////////////////////////////
+//
+class SteamServerQueries;
+
+// One ping, players or rules query; each in-flight query has its own response object so any number can run at once.
+class SteamServerQuery : public ISteamMatchmakingPingResponse, public ISteamMatchmakingPlayersResponse, public ISteamMatchmakingRulesResponse {
+	friend class SteamServerQueries;
+
+	public:
+		SteamServerQuery(uint64_t new_job, int new_kind, uint64_t new_started);
+
+		// ISteamMatchmakingPingResponse
+		virtual void ServerResponded(gameserveritem_t& server);
+		virtual void ServerFailedToRespond();
+
+		// ISteamMatchmakingPlayersResponse
+		virtual void AddPlayerToList(const char* name, int score, float time_played);
+		virtual void PlayersFailedToRespond();
+		virtual void PlayersRefreshComplete();
+
+		// ISteamMatchmakingRulesResponse
+		virtual void RulesResponded(const char* rule, const char* value);
+		virtual void RulesFailedToRespond();
+		virtual void RulesRefreshComplete();
+
+	private:
+		uint64_t job;
+		int kind;
+		HServerQuery handle;
+		uint64_t started;
+		bool done;
+		bool failed;
+		Dictionary details;
+		Array players;
+		Dictionary rules;
+};
+
+// Runs ping, players and rules queries for many servers with a limit on how many are in flight, highest priority first, cancelling any that time out. Each server's results are gathered into one dictionary.
+class SteamServerQueries {
+	public:
+		enum Kind {
+			QUERY_PING = 1, QUERY_PLAYERS = 2, QUERY_RULES = 4
+		};
+		struct Result {
+			uint32 ip;
+			uint16 port;
+			Dictionary data;
+		};
+
+		SteamServerQueries();
+		~SteamServerQueries();
+
+		void set_limits(uint32_t new_max_in_flight, uint64_t new_timeout);
+		bool queue(uint32 ip, uint16 port, int kinds, int priority);
+		HServerQuery start(uint32 ip, uint16 port, int kind);
+		bool cancel(HServerQuery handle);
+		bool was_reaped(HServerQuery handle) const;
+		void cancel_pending();
+		void clear();
+		void update(uint64_t now, std::vector<Result>& completed);
+
+		bool is_active() const { return !jobs.empty(); }
+		uint32_t get_pending_count() const { return pending.size(); }
+		uint32_t get_in_flight_count() const { return in_flight.size(); }
+
+	private:
+		struct Job {
+			uint32 ip;
+			uint16 port;
+			int kinds;
+			int running;
+			int failed;
+			int priority;
+			uint64_t sequence;
+			Dictionary result;
+		};
+		struct PendingKey {
+			int priority;
+			uint64_t sequence;
+			uint64_t job;
+			bool operator<(const PendingKey& other) const {
+				if(priority != other.priority){
+					return priority > other.priority;
+				}
+				return sequence < other.sequence;
+			}
+		};
+
+		Job& get_job(uint32 ip, uint16 port);
+		HServerQuery launch(uint64_t key, Job& job, int kind, uint64_t now);
+		void finish(SteamServerQuery* query);
+
+		std::map<uint64_t, Job> jobs;
+		std::set<PendingKey> pending;
+		std::vector<SteamServerQuery*> in_flight;
+		std::deque<HServerQuery> reaped;
+		uint32_t max_in_flight;
+		uint64_t timeout;
+		uint64_t sequence;
+};
+
+#endif // GODOTSTEAM_SERVERS_H
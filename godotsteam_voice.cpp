@@ -0,0 +1,286 @@
+/////////////////////////////////////////////////
+///// HEADER INCLUDES
+/////////////////////////////////////////////////
+//
+// Include the voice header
+#include "godotsteam_voice.h"
+
+// Include Godot headers
+#include "servers/audio_server.h"
+
+// Include GodotSteam header
+#include "godotsteam.h"
+
+
+/////////////////////////////////////////////////
+///// DEFINING CONSTANTS
+/////////////////////////////////////////////////
+//
+// Define Voice Mixer constants
+#define VOICE_BUFFER_SECONDS 1
+#define VOICE_JITTER_SMOOTHING 16.0f
+#define VOICE_JITTER_MULTIPLIER 3.0f
+#define VOICE_CONCEALMENT_HISTORY 0.01f
+#define VOICE_CONCEALMENT_MAX 0.06f
+
+
+/////////////////////////////////////////////////
+///// VOICE MIXER
+/////////////////////////////////////////////////
+//
+SteamVoiceMixer::SteamVoiceMixer(){
+	sample_rate = 0;
+	min_delay = 0.04;
+	max_delay = 0.3;
+}
+
+// Set the PCM sample rate and the range the adaptive playout delay may move in, in seconds. Existing buffers are dropped if the rate changes.
+void SteamVoiceMixer::configure(uint32_t new_sample_rate, float new_min_delay, float new_max_delay){
+	MutexLock lock(mutex);
+	if(new_sample_rate != sample_rate){
+		speakers.clear();
+	}
+	sample_rate = new_sample_rate;
+	min_delay = CLAMP(new_min_delay, 0.0f, (float)VOICE_BUFFER_SECONDS);
+	max_delay = CLAMP(new_max_delay, min_delay, (float)VOICE_BUFFER_SECONDS);
+}
+
+// Add decoded PCM for a speaker. Arrival spacing against the audio duration of the previous packet feeds the jitter estimate, which sets the playout delay.
+void SteamVoiceMixer::push(uint64_t speaker, const int16_t* samples, uint32_t count, uint64_t arrival_time, uint32_t lost){
+	MutexLock lock(mutex);
+	if(sample_rate == 0 || count == 0){
+		return;
+	}
+	JitterBuffer &buffer = speakers[speaker];
+	if(buffer.samples.empty()){
+		buffer.samples.resize(sample_rate * VOICE_BUFFER_SECONDS);
+		buffer.history.resize(MAX((uint32_t)(sample_rate * VOICE_CONCEALMENT_HISTORY), (uint32_t)1));
+		buffer.target = (uint32_t)(min_delay * sample_rate);
+	}
+	buffer.lost += lost;
+	// Interarrival jitter, smoothed the same way as RTP
+	if(buffer.last_arrival != 0 && arrival_time > buffer.last_arrival){
+		float spacing = (arrival_time - buffer.last_arrival) / 1000000.0f;
+		float expected = buffer.last_count / (float)sample_rate;
+		buffer.jitter += (fabsf(spacing - expected) - buffer.jitter) / VOICE_JITTER_SMOOTHING;
+	}
+	buffer.last_arrival = arrival_time;
+	buffer.last_count = count;
+	float delay = CLAMP(min_delay + VOICE_JITTER_MULTIPLIER * buffer.jitter, min_delay, max_delay);
+	buffer.target = (uint32_t)(delay * sample_rate);
+	// Never hold more than the buffer can store
+	uint32_t capacity = buffer.samples.size();
+	if(count > capacity){
+		samples += count - capacity;
+		count = capacity;
+	}
+	uint64_t available = buffer.write_position - buffer.read_position;
+	if(available + count > capacity){
+		uint64_t overflow = available + count - capacity;
+		buffer.read_position += overflow;
+		buffer.dropped += overflow;
+	}
+	for(uint32_t i = 0; i < count; i++){
+		buffer.samples[(buffer.write_position + i) % capacity] = samples[i];
+	}
+	buffer.write_position += count;
+	// Trim latency that built up after a burst, keeping the target delay
+	available = buffer.write_position - buffer.read_position;
+	if(buffer.playing && available > (uint64_t)buffer.target * 2 + count){
+		uint64_t excess = available - buffer.target - count;
+		buffer.read_position += excess;
+		buffer.dropped += excess;
+	}
+}
+
+// Mix one speaker, or every speaker when speaker is 0, into the buffer; called from the audio thread.
+void SteamVoiceMixer::mix(uint64_t speaker, AudioFrame* buffer, int frames){
+	for(int i = 0; i < frames; i++){
+		buffer[i] = AudioFrame(0, 0);
+	}
+	MutexLock lock(mutex);
+	if(speaker != 0){
+		std::unordered_map<uint64_t, JitterBuffer>::iterator found = speakers.find(speaker);
+		if(found != speakers.end()){
+			mix_speaker(found->second, buffer, frames);
+		}
+		return;
+	}
+	for(std::unordered_map<uint64_t, JitterBuffer>::iterator found = speakers.begin(); found != speakers.end(); ++found){
+		mix_speaker(found->second, buffer, frames);
+	}
+}
+
+// Drop a speaker's buffer.
+void SteamVoiceMixer::remove_speaker(uint64_t speaker){
+	MutexLock lock(mutex);
+	speakers.erase(speaker);
+}
+
+// Drop every speaker's buffer.
+void SteamVoiceMixer::clear(){
+	MutexLock lock(mutex);
+	speakers.clear();
+}
+
+// Get the buffered and target delay, jitter estimate (all in seconds) and loss counters for a speaker.
+bool SteamVoiceMixer::get_speaker_status(uint64_t speaker, float& depth, float& target, float& jitter, uint32_t& lost, uint32_t& concealed, uint32_t& underruns, uint32_t& dropped){
+	MutexLock lock(mutex);
+	std::unordered_map<uint64_t, JitterBuffer>::const_iterator found = speakers.find(speaker);
+	if(found == speakers.end() || sample_rate == 0){
+		return false;
+	}
+	depth = (found->second.write_position - found->second.read_position) / (float)sample_rate;
+	target = found->second.target / (float)sample_rate;
+	jitter = found->second.jitter;
+	lost = found->second.lost;
+	concealed = found->second.concealed;
+	underruns = found->second.underruns;
+	dropped = found->second.dropped;
+	return true;
+}
+
+// Add a speaker's buffered audio to the output, waiting until the target delay is buffered before playing and concealing underruns by fading out the last played audio.
+void SteamVoiceMixer::mix_speaker(JitterBuffer& buffer, AudioFrame* output, int frames){
+	uint32_t capacity = buffer.samples.size();
+	uint64_t available = buffer.write_position - buffer.read_position;
+	if(!buffer.playing){
+		if(available == 0 || available < buffer.target){
+			return;
+		}
+		buffer.playing = true;
+		buffer.concealed_run = 0;
+	}
+	int played = (int)MIN((uint64_t)frames, available);
+	for(int i = 0; i < played; i++){
+		int16_t sample = buffer.samples[(buffer.read_position + i) % capacity];
+		float value = sample / 32768.0f;
+		output[i] += AudioFrame(value, value);
+		remember(buffer, sample);
+	}
+	buffer.read_position += played;
+	if(played > 0){
+		buffer.concealed_run = 0;
+	}
+	if(played == frames){
+		return;
+	}
+	// Underrun: repeat the last few milliseconds with a fade, then go quiet and rebuffer
+	uint32_t history_size = buffer.history.size();
+	uint32_t concealment_max = (uint32_t)(VOICE_CONCEALMENT_MAX * sample_rate);
+	for(int i = played; i < frames; i++){
+		if(buffer.concealed_run >= concealment_max){
+			buffer.playing = false;
+			buffer.underruns++;
+			return;
+		}
+		float fade = 1.0f - (float)buffer.concealed_run / concealment_max;
+		float value = buffer.history[(buffer.history_position + buffer.concealed_run) % history_size] / 32768.0f * fade;
+		output[i] += AudioFrame(value, value);
+		buffer.concealed_run++;
+		buffer.concealed++;
+	}
+}
+
+// Keep the last few milliseconds played for concealment in a small ring.
+void SteamVoiceMixer::remember(JitterBuffer& buffer, int16_t sample){
+	buffer.history[buffer.history_position] = sample;
+	buffer.history_position = (buffer.history_position + 1) % buffer.history.size();
+}
+
+
+/////////////////////////////////////////////////
+///// VOICE STREAM
+/////////////////////////////////////////////////
+//
+SteamVoiceStream::SteamVoiceStream(){
+	speaker = 0;
+}
+
+// Set which Steam ID this stream plays, or 0 for every speaker.
+void SteamVoiceStream::set_speaker(uint64_t new_speaker){
+	speaker = new_speaker;
+}
+
+uint64_t SteamVoiceStream::get_speaker() const {
+	return speaker;
+}
+
+Ref<AudioStreamPlayback> SteamVoiceStream::instance_playback(){
+	Ref<SteamVoiceStreamPlayback> playback;
+	playback.instance();
+	playback->speaker = speaker;
+	return playback;
+}
+
+String SteamVoiceStream::get_stream_name() const {
+	return "SteamVoice";
+}
+
+float SteamVoiceStream::get_length() const {
+	return 0;
+}
+
+void SteamVoiceStream::_bind_methods(){
+	ClassDB::bind_method(D_METHOD("set_speaker", "speaker"), &SteamVoiceStream::set_speaker);
+	ClassDB::bind_method(D_METHOD("get_speaker"), &SteamVoiceStream::get_speaker);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "speaker"), "set_speaker", "get_speaker");
+}
+
+
+/////////////////////////////////////////////////
+///// VOICE STREAM PLAYBACK
+/////////////////////////////////////////////////
+//
+SteamVoiceStreamPlayback::SteamVoiceStreamPlayback(){
+	speaker = 0;
+	active = false;
+	mixed = 0;
+}
+
+void SteamVoiceStreamPlayback::start(float from_position){
+	mixed = 0;
+	active = true;
+	_begin_resample();
+}
+
+void SteamVoiceStreamPlayback::stop(){
+	active = false;
+}
+
+bool SteamVoiceStreamPlayback::is_playing() const {
+	return active;
+}
+
+int SteamVoiceStreamPlayback::get_loop_count() const {
+	return 0;
+}
+
+float SteamVoiceStreamPlayback::get_playback_position() const {
+	float rate = const_cast<SteamVoiceStreamPlayback*>(this)->get_stream_sampling_rate();
+	return mixed / rate;
+}
+
+void SteamVoiceStreamPlayback::seek(float time){
+	// Live voice cannot seek
+}
+
+void SteamVoiceStreamPlayback::_mix_internal(AudioFrame* buffer, int frames){
+	Steam* steam = Steam::get_singleton();
+	if(!active || steam == NULL){
+		for(int i = 0; i < frames; i++){
+			buffer[i] = AudioFrame(0, 0);
+		}
+		return;
+	}
+	steam->get_voice_mixer()->mix(speaker, buffer, frames);
+	mixed += frames;
+}
+
+float SteamVoiceStreamPlayback::get_stream_sampling_rate(){
+	Steam* steam = Steam::get_singleton();
+	if(steam == NULL || steam->get_voice_mixer()->get_sample_rate() == 0){
+		return AudioServer::get_singleton()->get_mix_rate();
+	}
+	return steam->get_voice_mixer()->get_sample_rate();
+}
@@ -0,0 +1,119 @@
+#ifndef GODOTSTEAM_VOICE_H
+#define GODOTSTEAM_VOICE_H
+
+/////////////////////////////////////////////////
+// INCLUDE HEADERS
+/////////////////////////////////////////////////
+//
+// Include INT types header
+#include <inttypes.h>
+
+// Include Godot headers
+#include "core/os/mutex.h"
+#include "servers/audio/audio_stream.h"
+
+// Include some system headers
+#include "unordered_map"
+#include "vector"
+
+
+/////////////////////////////////////////////////
+///// VOICE MIXER
+/////////////////////////////////////////////////
+//
+// Per-speaker jitter buffers filled from the main thread and drained by SteamVoiceStream on the audio thread.
+class SteamVoiceMixer {
+	public:
+		SteamVoiceMixer();
+
+		void configure(uint32_t sample_rate, float min_delay, float max_delay);
+		void push(uint64_t speaker, const int16_t* samples, uint32_t count, uint64_t arrival_time, uint32_t lost);
+		void mix(uint64_t speaker, AudioFrame* buffer, int frames);
+		void remove_speaker(uint64_t speaker);
+		void clear();
+
+		uint32_t get_sample_rate() const { return sample_rate; }
+		bool get_speaker_status(uint64_t speaker, float& depth, float& target, float& jitter, uint32_t& lost, uint32_t& concealed, uint32_t& underruns, uint32_t& dropped);
+
+	private:
+		struct JitterBuffer {
+			std::vector<int16_t> samples;
+			uint64_t read_position = 0;
+			uint64_t write_position = 0;
+			bool playing = false;
+			float jitter = 0.0;
+			uint64_t last_arrival = 0;
+			uint32_t last_count = 0;
+			uint32_t target = 0;
+			std::vector<int16_t> history;
+			uint32_t history_position = 0;
+			uint32_t concealed_run = 0;
+			uint32_t lost = 0;
+			uint32_t concealed = 0;
+			uint32_t underruns = 0;
+			uint32_t dropped = 0;
+		};
+
+		void mix_speaker(JitterBuffer& buffer, AudioFrame* output, int frames);
+		void remember(JitterBuffer& buffer, int16_t sample);
+
+		Mutex mutex;
+		uint32_t sample_rate;
+		float min_delay;
+		float max_delay;
+		std::unordered_map<uint64_t, JitterBuffer> speakers;
+};
+
+
+/////////////////////////////////////////////////
+///// VOICE STREAM
+/////////////////////////////////////////////////
+//
+class SteamVoiceStreamPlayback;
+
+// Plays received Steam voice; a speaker of 0 mixes every speaker into one stream, any other Steam ID plays only that speaker for positional voice. Streams share each speaker's jitter buffer, so only one stream may play a given speaker.
+class SteamVoiceStream : public AudioStream {
+	GDCLASS(SteamVoiceStream, AudioStream);
+
+	public:
+		void set_speaker(uint64_t new_speaker);
+		uint64_t get_speaker() const;
+
+		virtual Ref<AudioStreamPlayback> instance_playback();
+		virtual String get_stream_name() const;
+		virtual float get_length() const;
+
+		SteamVoiceStream();
+
+	protected:
+		static void _bind_methods();
+
+	private:
+		uint64_t speaker;
+};
+
+class SteamVoiceStreamPlayback : public AudioStreamPlaybackResampled {
+	GDCLASS(SteamVoiceStreamPlayback, AudioStreamPlaybackResampled);
+	friend class SteamVoiceStream;
+
+	public:
+		virtual void start(float from_position = 0.0);
+		virtual void stop();
+		virtual bool is_playing() const;
+		virtual int get_loop_count() const;
+		virtual float get_playback_position() const;
+		virtual void seek(float time);
+
+		SteamVoiceStreamPlayback();
+
+	protected:
+		virtual void _mix_internal(AudioFrame* buffer, int frames);
+		virtual float get_stream_sampling_rate();
+
+	private:
+		uint64_t speaker;
+		bool active;
+		uint64_t mixed;
+};
+
+#endif // GODOTSTEAM_VOICE_H
@@ -2,11 +2,19 @@
 #include "core/class_db.h"
 #include "core/engine.h"
 #include "godotsteam.h"
+#include "godotsteam_html.h"
+#include "godotsteam_servers.h"
+#include "godotsteam_voice.h"
 
 static Steam* SteamPtr = NULL;
 
 void register_godotsteam_types(){
 	ClassDB::register_class<Steam>();
+	ClassDB::register_class<SteamHTMLRect>();
+	ClassDB::register_class<SteamHTMLTexture>();
+	ClassDB::register_class<SteamServerFilter>();
+	ClassDB::register_class<SteamVoiceStream>();
+	ClassDB::register_class<SteamVoiceStreamPlayback>();
 	SteamPtr = memnew(Steam);
 	Engine::get_singleton()->add_singleton(Engine::Singleton("Steam",Steam::get_singleton()));
 }